@@ -0,0 +1,63 @@
+#ifndef ADMISSION_CONTROLLER_H
+#define ADMISSION_CONTROLLER_H
+
+#include <Arduino.h>
+#include "ESP32Config.h"
+
+// Contrôle d'admission des requêtes HTTP : limite le nombre de requêtes en
+// vol, applique des seaux à jetons par IP client (budgets séparés lecture /
+// contrôle) et rejette la charge quand le heap libre passe sous un seuil.
+// Toutes les méthodes sont appelées depuis la tâche AsyncTCP (pas de verrou).
+class AdmissionController {
+public:
+    enum RequestClass {
+        READ,       // /, /api/status, /api/distance, ...
+        CONTROL     // POST /api/gate, /api/auto
+    };
+    
+    enum Decision {
+        ADMITTED,
+        RATE_LIMITED,   // -> 429
+        OVERLOADED,     // Trop de requêtes en vol -> 503
+        LOW_MEMORY      // Heap sous le seuil -> 503
+    };
+    
+    struct Counters {
+        uint32_t admitted;
+        uint32_t rateLimited;
+        uint32_t overloaded;
+        uint32_t lowMemory;
+    };
+    
+private:
+    struct TokenBucket {
+        uint32_t milliTokens;   // Jetons x1000 pour rester en entiers
+        unsigned long lastRefill;
+    };
+    
+    struct ClientEntry {
+        uint32_t ip;
+        unsigned long lastSeen;
+        TokenBucket buckets[2];
+    };
+    
+    ClientEntry clients[ADMISSION_MAX_CLIENTS];
+    uint8_t inFlight;
+    Counters counters;
+    
+    ClientEntry* findOrCreateClient(uint32_t ip, unsigned long now);
+    bool takeToken(TokenBucket& bucket, RequestClass cls, unsigned long now);
+    
+public:
+    AdmissionController();
+    
+    Decision admit(uint32_t clientIP, RequestClass cls, uint32_t freeHeap);
+    void release();
+    
+    uint8_t getInFlight() const;
+    const Counters& getCounters() const;
+    uint32_t getShedTotal() const;
+    static const char* decisionToString(Decision d);
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef APPROACH_ESTIMATOR_H
+#define APPROACH_ESTIMATOR_H
+
+#include <Arduino.h>
+
+// Appelé quand un véhicule doit atteindre le seuil dans moins de leadTimeMs
+typedef void (*ApproachCallback)(float etaMs, float speedCmS, float confidence);
+
+// Estimateur alpha-bêta de la vitesse d'approche à partir du flux de distances.
+// Coût constant par échantillon (quelques multiplications flottantes), aucun
+// historique stocké.
+class ApproachEstimator {
+private:
+    float alpha;
+    float beta;
+    float position;         // cm, filtrée
+    float velocity;         // cm/s, négative quand l'objet s'approche
+    float residualVar;      // Moyenne mobile du carré des résidus (cm²)
+    unsigned long lastSampleMs;
+    uint16_t samples;
+    uint8_t consecutiveOutliers;
+    
+    ApproachCallback callback;
+    float callbackThresholdCm;
+    unsigned long callbackLeadMs;
+    float callbackMinConfidence;
+    bool callbackFired;
+    
+    void checkCallback();
+    
+public:
+    ApproachEstimator(float a = 0.5, float b = 0.25);
+    
+    void update(float distanceCm, unsigned long nowMs);
+    void reset();
+    
+    float getPosition() const;
+    float getVelocity() const;
+    float getApproachSpeed() const;     // cm/s, 0 si l'objet ne s'approche pas
+    float getConfidence() const;        // 0..1
+    // Temps estimé avant que la distance passe sous thresholdCm
+    // (0 = déjà dessous, -1 = pas d'approche détectée)
+    float getTimeToThresholdMs(float thresholdCm) const;
+    
+    void setApproachCallback(ApproachCallback cb, float thresholdCm, unsigned long leadMs,
+                             float minConfidence = 0.5);
+};
+
+#endif
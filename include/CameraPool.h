@@ -0,0 +1,108 @@
+#ifndef CAMERA_POOL_H
+#define CAMERA_POOL_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include "ESP32Config.h"
+#include "ESP32CAMClient.h"
+#include "DeadlineMonitor.h"
+
+// Pool de caméras ESP32-CAM. Chaque caméra a sa propre tâche FreeRTOS : une
+// capture est envoyée à toutes les caméras en parallèle et la latence totale
+// est celle de la caméra la plus lente, pas la somme. Les appels réseau vers
+// une caméra ne sont faits que depuis sa tâche.
+class CameraPool {
+public:
+    enum Command {
+        CMD_CAPTURE,
+        CMD_PROBE
+    };
+    
+    enum TriggerResult {
+        TRIGGER_STARTED,
+        TRIGGER_QUEUED,         // Capture lancée dès la fin du sondage en cours
+        TRIGGER_BUSY,           // Capture déjà en cours ou en attente
+        TRIGGER_UNAVAILABLE     // Pool non démarré ou sans caméra
+    };
+    
+    struct CameraResult {
+        bool success;
+        uint32_t latencyMs;
+        uint32_t completedAt;   // millis() de fin, 0 = jamais exécuté
+    };
+    
+    struct RoundInfo {
+        uint32_t id;
+        Command command;
+        bool inProgress;
+        uint32_t startedAt;
+        uint32_t queuedMs;      // Attente derrière un sondage avant le début
+        uint32_t latencyMs;     // Début de la ronde -> fin de la dernière caméra
+        uint8_t succeeded;
+        uint8_t cameras;
+    };
+    
+private:
+    struct CameraSlot {
+        const char* name;
+        char taskName[16];
+        int deadlineId;
+        ESP32CAMClient* client;
+        TaskHandle_t task;
+        CameraPool* pool;
+        uint8_t index;
+        bool reachable;
+        CameraResult lastCapture;
+        CameraResult lastProbe;
+    };
+    
+    CameraSlot slots[CAMERA_POOL_MAX];
+    uint8_t cameraCount;
+    EventGroupHandle_t doneBits;
+    portMUX_TYPE lock;
+    
+    RoundInfo round;
+    Command roundCommand;
+    unsigned long roundDeadline;
+    uint8_t remaining;
+    bool capturePending;
+    uint32_t captureRequestedAt;
+    
+    static void workerTask(void* param);
+    void runCommand(CameraSlot& slot);
+    EventBits_t allBits() const;
+    // Sous verrou : prépare la ronde ; dispatchRound() réveille ensuite les tâches
+    void beginRoundLocked(Command command, unsigned long now, uint32_t queuedMs);
+    void dispatchRound();
+    
+public:
+    CameraPool();
+    
+    bool addCamera(const char* name, ESP32CAMClient* client);
+    bool begin();
+    
+    // Non bloquants. Une capture demandée pendant un sondage est mise en attente
+    // et lancée par service() dès la fin du sondage (borné par
+    // CAM_REACHABLE_TIMEOUT_MS) ; roundId reçoit le numéro de la ronde de capture
+    TriggerResult triggerCapture(uint32_t* roundId = nullptr);
+    // false si une ronde est en cours ou une capture en attente
+    bool triggerProbe();
+    // À appeler depuis loop() : lance la capture en attente une fois le sondage terminé
+    void service();
+    // Attend la fin de la ronde en cours (true si toutes les caméras ont répondu)
+    bool waitForRound(unsigned long timeoutMs);
+    
+    uint8_t getCameraCount() const;
+    uint8_t getHealthyCount();
+    ESP32CAMClient* getCamera(uint8_t index);
+    const char* getCameraName(uint8_t index) const;
+    bool isReachable(uint8_t index);
+    CameraResult getLastCapture(uint8_t index);
+    CameraResult getLastProbe(uint8_t index);
+    RoundInfo getLastRound();
+    // État le plus dégradé des disjoncteurs (OPEN > HALF_OPEN > CLOSED)
+    CircuitBreaker::State getWorstCircuit();
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef CIRCUIT_BREAKER_H
+#define CIRCUIT_BREAKER_H
+
+#include <Arduino.h>
+
+// Disjoncteur pour les appels réseau : après N échecs consécutifs le circuit
+// s'ouvre et les appels échouent immédiatement pendant openDurationMs, puis
+// un nombre limité d'appels de test (half-open) décide de la refermeture.
+class CircuitBreaker {
+public:
+    enum State {
+        CLOSED,
+        OPEN,
+        HALF_OPEN
+    };
+    
+private:
+    State state;
+    uint8_t failureThreshold;
+    uint8_t halfOpenMaxProbes;
+    unsigned long openDurationMs;
+    
+    uint8_t consecutiveFailures;
+    uint8_t probesInFlight;
+    unsigned long openedAt;
+    unsigned long episodeStart;     // Premier passage CLOSED -> OPEN
+    unsigned long lastRecoveryMs;   // Durée du dernier épisode OPEN -> CLOSED
+    uint32_t fastFailCount;
+    uint32_t tripCount;
+    
+    portMUX_TYPE lock;
+    
+    void tripLocked(unsigned long now);
+    
+public:
+    CircuitBreaker(uint8_t failures = 3, unsigned long openMs = 10000, uint8_t probes = 1);
+    
+    bool allowRequest();
+    void recordSuccess();
+    void recordFailure();
+    void reset();
+    
+    State getState();
+    const char* getStateString();
+    uint8_t getConsecutiveFailures() const;
+    uint32_t getFastFailCount() const;
+    uint32_t getTripCount() const;
+    unsigned long getLastRecoveryMs() const;
+    unsigned long getRetryInMs();
+    
+    static const char* stateToString(State s);
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include <Arduino.h>
+#include "ESP32Config.h"
+
+// Dépassement d'échéance, conservé en mémoire RTC à travers les resets
+struct OverrunRecord {
+    char name[12];
+    uint32_t durationMs;
+    uint32_t budgetMs;
+    uint32_t uptimeMs;      // millis() au moment du dépassement
+    uint32_t boot;          // Numéro de boot (compteur RTC)
+    uint8_t ongoing;        // 1 = opération encore bloquée quand le watchdog a été coupé
+};
+
+// Surveillance logicielle des échéances : chaque sous-système déclare un
+// budget, encadre ses opérations par begin()/end() (ou DeadlineScope) et le
+// moniteur enregistre les dépassements. Le watchdog matériel n'est alimenté
+// par feedIfHealthy() que si aucune opération n'est bloquée.
+class DeadlineMonitor {
+public:
+    struct TaskInfo {
+        const char* name;
+        uint32_t budgetMs;
+        uint32_t hangMs;
+        volatile uint32_t startedAt;
+        volatile bool active;
+        uint32_t lastMs;
+        uint32_t maxMs;
+        uint32_t overruns;
+        bool hangReported;
+    };
+    
+private:
+    static TaskInfo tasks[DEADLINE_MAX_TASKS];
+    static uint8_t taskCount;
+    static volatile bool healthy;
+    static bool supervised;
+    static uint32_t checkpoints;
+    static portMUX_TYPE lock;
+    
+    static void recordOverrun(const TaskInfo& task, uint32_t durationMs, bool ongoing);
+    
+public:
+    static void init();
+    
+    // Retourne un identifiant, -1 si la table est pleine
+    static int registerTask(const char* name, uint32_t budgetMs, uint32_t hangMs = 0);
+    static void begin(int id);
+    static void end(int id);
+    
+    // Vérifie les opérations en cours et persiste les blocages. Appelé
+    // périodiquement par un esp_timer lancé par startSupervisor(), pour que
+    // le blocage de loop() elle-même soit enregistré avant le reset
+    static bool check();
+    static bool startSupervisor();
+    // Appelé depuis loop() (seule tâche abonnée au watchdog) : alimente le
+    // watchdog seulement si le dernier check() n'a trouvé aucun blocage
+    static bool feedIfHealthy();
+    
+    static bool isHealthy();
+    static uint8_t getTaskCount();
+    static const TaskInfo& getTask(uint8_t index);
+    static uint32_t getCheckpointCount();
+    static uint32_t getBootCount();
+    // Dépassements persistés, du plus récent au plus ancien
+    static uint8_t getPersistedCount();
+    static OverrunRecord getPersisted(uint8_t index);
+    static void printPersisted();
+};
+
+// Encadre une portée : begin() à la construction, end() à la destruction
+class DeadlineScope {
+private:
+    int id;
+    
+public:
+    explicit DeadlineScope(int taskId) : id(taskId) { DeadlineMonitor::begin(id); }
+    ~DeadlineScope() { DeadlineMonitor::end(id); }
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define DISTANCE_SENSOR_H
 
 #include <Arduino.h>
+#include "ApproachEstimator.h"
 
 class DistanceSensor {
 private:
@@ -9,14 +10,23 @@ private:
     int echoPin;
     float lastDistance;
     unsigned long lastReadTime;
+    ApproachEstimator estimator;
+    int deadlineId;
     
 public:
     DistanceSensor(int trig, int echo);
     bool init();
     float readDistance();
+    // Conversion + filtrage d'une durée d'écho brute (µs), séparé de la lecture
+    // matérielle pour pouvoir rejouer des traces enregistrées sur l'hôte
+    float processEcho(long durationUs);
     float getLastDistance() const;
+    // millis() du dernier écho valide : getLastDistance() n'est pas mise à jour
+    // sur timeout ou hors plage, elle vieillit quand l'objet quitte le champ
+    unsigned long getLastValidReadTime() const;
     bool isObjectDetected(float thresholdCm = 20.0);
     void update();
+    ApproachEstimator& getEstimator();
 };
 
 #endif
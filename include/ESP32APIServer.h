@@ -6,28 +6,42 @@
 #include <ESPAsyncWebServer.h>
 #include "DistanceSensor.h"
 #include "ServoController.h"
-#include "ESP32CAMClient.h"
+#include "CameraPool.h"
+#include "SystemState.h"
+#include "AdmissionController.h"
+#include "TimeSeriesHistory.h"
+#include "DeadlineMonitor.h"
 
 class ESP32APIServer {
 private:
     AsyncWebServer server;
     DistanceSensor* distanceSensor;
     ServoController* servoController;
-    ESP32CAMClient* camClient;
+    CameraPool* cameraPool;
+    SystemState* systemState;
+    TimeSeriesHistory* history;
     bool autoPhotoEnabled;
     unsigned long lastAutoPhoto;
+    AdmissionController admission;
+    int readDeadlineId;
+    int controlDeadlineId;
     
     void setupRoutes();
+    bool admitRequest(AsyncWebServerRequest *request, AdmissionController::RequestClass cls);
+    // Action supplémentaire à la fin d'une requête admise (libère aussi la place)
+    void onRequestEnd(AsyncWebServerRequest *request, std::function<void()> action);
     String generateWebInterface();
     
 public:
     ESP32APIServer(int port = 80);
-    bool init(DistanceSensor* sensor, ServoController* servo, ESP32CAMClient* cam);
+    bool init(DistanceSensor* sensor, ServoController* servo, CameraPool* cameras, SystemState* state,
+              TimeSeriesHistory* hist);
     void begin();
     String getIPAddress();
     bool isAutoPhotoEnabled() const;
     void setAutoPhoto(bool enabled);
     void handleAutoPhoto();
+    const AdmissionController& getAdmission() const;
 };
 
 #endif
@@ -3,23 +3,47 @@
 
 #include <Arduino.h>
 #include <HTTPClient.h>
-#include <ArduinoJson.h>
+#include "CircuitBreaker.h"
 
 class ESP32CAMClient {
+public:
+    // Issue du dernier appel : une échéance dépassée n'est pas une panne caméra
+    enum CallResult {
+        CALL_NONE,
+        CALL_OK,
+        CALL_DEADLINE_EXCEEDED,
+        CALL_CIRCUIT_OPEN,
+        CALL_HTTP_ERROR,
+        CALL_TRANSPORT_ERROR
+    };
+    
 private:
     String esp32camIP;
     HTTPClient httpClient;
     unsigned long lastPhotoRequest;
+    CircuitBreaker breaker;
+    volatile CallResult lastResult;
+    
+    static unsigned long deadlineIn(unsigned long budgetMs);
+    static bool deadlinePassed(unsigned long deadline);
+    bool beginCall(const char* path, unsigned long deadline, const char* operation);
+    void endCall(int httpResponseCode);
     
 public:
     ESP32CAMClient(const String& ip);
     bool init();
-    bool requestPhoto();
+    // Chaque appel prend une échéance absolue (valeur de millis()).
+    // 0 = budget par défaut défini dans ESP32Config.h
+    bool requestPhoto(unsigned long deadline = 0);
     String requestPhotoData(); // Nouvelle méthode pour récupérer l'image
-    String getStatus();
-    bool isReachable();
+    bool isReachable(unsigned long deadline = 0);
     void setIP(const String& ip);
     String getIP() const;
+    
+    CircuitBreaker& getBreaker();
+    const char* getCircuitState();
+    CallResult getLastResult() const;
+    static const char* resultToString(CallResult result);
 };
 
 #endif
@@ -7,18 +7,60 @@
 #define WEB_SERVER_PORT 80
 
 // Configuration ESP32-CAM
-#define ESP32CAM_IP "192.168.1.100"
+#define ESP32CAM_IP "192.168.1.100"        // Caméra avant (principale)
+#define ESP32CAM_REAR_IP "192.168.1.101"   // Caméra arrière (plaque arrière)
+#define CAMERA_POOL_MAX 4                  // Caméras max par voie
+#define CAMERA_TASK_STACK 6144             // Pile d'une tâche caméra (HTTPClient)
+#define CAMERA_TASK_CORE 0                 // Avec le réseau, loin de la boucle de contrôle
+#define CAM_PHOTO_TIMEOUT_MS 3000       // Budget par défaut de requestPhoto()
+#define CAM_REACHABLE_TIMEOUT_MS 1500   // Budget par défaut de isReachable()
+#define CAM_MIN_CALL_BUDGET_MS 100      // En dessous, l'appel n'est même pas tenté
+#define CAM_CONNECT_BUDGET_PCT 40       // Part du budget restant accordée à la connexion TCP
+#define CAM_BREAKER_FAILURE_THRESHOLD 3 // Échecs consécutifs avant ouverture du circuit
+#define CAM_BREAKER_OPEN_MS 10000       // Durée fast-fail avant un appel de test
+#define CAM_BREAKER_HALF_OPEN_PROBES 1  // Appels de test autorisés en half-open
 
 // Configuration matérielle ESP32
 #define SERVO_PIN 13
 #define TRIG_PIN 5
 #define ECHO_PIN 18
 #define LED_PIN 12
+#define SERVO_MOVE_WAIT_MS 1200         // Attente max du mouvement en cours (loop() / API) avant abandon
 
 // Configuration système
 #define DETECTION_DISTANCE_CM 20
 #define UPDATE_INTERVAL_MS 2000  // Augmenter à 2000ms pour réduire la charge
 #define AUTO_PHOTO_INTERVAL_MS 5000  // Disabled in code to prevent failures
+#define STATE_PUBLISH_INTERVAL_MS 200    // Publication de l'instantané système
+#define CAM_HEALTH_INTERVAL_MS 15000     // Vérification ESP32-CAM depuis la boucle de contrôle
+#define CONTROL_CORE 1                   // Cœur attendu pour loop() (AsyncTCP sur l'autre)
+
+// Estimation de la vitesse d'approche
+#define APPROACH_RESET_GAP_MS 2000       // Trou dans le flux au-delà duquel le suivi repart de zéro
+#define APPROACH_MIN_SPEED_CM_S 3.0      // En dessous, l'objet est considéré immobile
+#define APPROACH_CONFIDENCE_SAMPLES 5    // Échantillons avant confiance maximale
+#define APPROACH_RESIDUAL_SCALE_CM 5.0   // Bruit résiduel qui divise la confiance par e
+#define APPROACH_OUTLIER_CM 40.0         // Écart à la prédiction au-delà duquel l'écho est ignoré
+#define APPROACH_MAX_OUTLIERS 3          // Aberrations consécutives = nouvel objet, suivi réinitialisé
+#define APPROACH_LEAD_MS 1500            // Anticipation : durée d'ouverture + marge
+#define APPROACH_EARLY_OPEN false        // Ouvrir la barrière avant l'arrivée du véhicule
+                                         // Limite : à la cadence capteur actuelle (500 ms), 94 % des annonces
+                                         // arrivent en retard à 200 cm/s (tools/estimator_bench.cpp) ;
+                                         // passer la lecture à 200 ms avant d'activer pour des véhicules rapides
+#define APPROACH_CLOSE_AFTER_CLEAR_MS 3000  // Fermeture après ouverture anticipée : aucun écho valide sous le seuil depuis ce délai
+#define APPROACH_OPEN_TIMEOUT_MS 10000      // Fermeture si le véhicule annoncé n'arrive jamais
+
+// Enregistrement de traces (8 octets par enregistrement)
+#define TRACE_BUFFER_RECORDS 1024           // 8 KB de RAM, ~8 min de capteur à 2 Hz
+#define TRACE_FLUSH_RECORDS 256             // Vidage flash par blocs de 2 KB
+#define TRACE_FILE_PATH "/trace.bin"
+#define TRACE_MAX_FILE_BYTES 524288         // 512 KB de flash, ~9 h de capteur à 2 Hz
+
+// Historique en RAM (budget fixe, voir TimeSeriesHistory.h)
+#define HISTORY_RAW_POINTS 320              // Brut, ~1 min à la cadence de loop()
+#define HISTORY_1S_POINTS 180               // Seaux de 1 s : 3 min
+#define HISTORY_10S_POINTS 180              // Seaux de 10 s : 30 min
+#define HISTORY_MAX_POINTS 200              // Points max renvoyés par /api/history
 
 // Configuration debug
 #define DEBUG_WATCHDOG true
@@ -26,4 +68,27 @@
 #define DEBUG_RESET_REASON true
 #define MEMORY_WARNING_THRESHOLD 50000  // Alerter si heap < 50KB
 
+// Surveillance des échéances (budgets par opération, en ms)
+#define DEADLINE_MAX_TASKS 12               // Opérations surveillées max
+#define DEADLINE_PERSISTED_OVERRUNS 8       // Dépassements conservés en RTC à travers les resets
+#define DEADLINE_HANG_FACTOR 10             // Blocage = budget x facteur : watchdog plus alimenté
+#define DEADLINE_CHECK_INTERVAL_MS 250      // Période du superviseur esp_timer (indépendant de loop())
+#define DEADLINE_WDT_TIMEOUT_S 30           // Watchdog matériel : loop() bloquée > hang doit rester < ce délai
+#define DEADLINE_LOOP_MS 800                // Itération de loop() hors delay final (ouverture anticipée incluse)
+#define DEADLINE_SENSOR_MS 30               // Lecture ultrasonique (pulseIn 15 ms max)
+#define DEADLINE_SERVO_MS 700               // Mouvement servo (delay 500 ms)
+#define DEADLINE_CAMERA_MS 3500             // Appel ESP32-CAM (budget photo + marge)
+#define DEADLINE_WEB_MS 100                 // Handler web dans la tâche AsyncTCP
+
+// Contrôle d'admission HTTP
+#define ADMISSION_MAX_INFLIGHT 6            // Requêtes simultanées max
+#define ADMISSION_CONTROL_RESERVED 2        // Places réservées au contrôle de la barrière
+#define ADMISSION_MAX_CLIENTS 8             // IP suivies pour les seaux à jetons
+#define ADMISSION_READ_RATE_PER_SEC 4       // Lectures par seconde et par IP
+#define ADMISSION_READ_BURST 8
+#define ADMISSION_CONTROL_RATE_PER_SEC 1    // Commandes par seconde et par IP
+#define ADMISSION_CONTROL_BURST 3
+#define ADMISSION_HEAP_WATERMARK 70000      // Sous ce seuil : lectures rejetées (503)
+#define ADMISSION_HEAP_CRITICAL 30000       // Sous ce seuil : tout est rejeté
+
 #endif
@@ -0,0 +1,58 @@
+#ifndef GATE_AUTOMATION_H
+#define GATE_AUTOMATION_H
+
+#include <Arduino.h>
+#include "ESP32Config.h"
+#include "DistanceSensor.h"
+#include "ServoController.h"
+
+// Ouverture anticipée et refermeture automatique de la barrière.
+// Le callback de l'estimateur s'exécute pendant la lecture capteur (créneau
+// "sensor" de DeadlineMonitor) : requestOpen() ne fait que lever un drapeau,
+// le mouvement servo est fait par update() depuis loop().
+class GateAutomation {
+public:
+    struct Stats {
+        uint32_t requests;          // Annonces reçues de l'estimateur
+        uint32_t opens;             // Ouvertures anticipées effectuées
+        uint32_t closedPassed;      // Refermetures après passage du véhicule
+        uint32_t closedNoShow;      // Refermetures, véhicule jamais arrivé
+        uint32_t lastOpenDelayMs;   // Annonce -> barrière ouverte
+    };
+    
+private:
+    DistanceSensor& sensor;
+    ServoController& servo;
+    bool enabled;
+    float thresholdCm;
+    unsigned long closeAfterClearMs;
+    unsigned long openTimeoutMs;
+    
+    volatile bool openRequested;
+    unsigned long requestedAt;
+    
+    bool active;
+    bool heldClosed;                // Refermée par l'opérateur, véhicule encore là
+    bool vehicleSeen;
+    unsigned long openedAt;
+    unsigned long lastPresence;     // millis() du dernier écho valide sous le seuil
+    Stats stats;
+    
+    bool vehiclePresent(unsigned long now);
+    
+public:
+    GateAutomation(DistanceSensor& sensor, ServoController& servo,
+                   bool enabled = APPROACH_EARLY_OPEN, float thresholdCm = DETECTION_DISTANCE_CM,
+                   unsigned long closeAfterClearMs = APPROACH_CLOSE_AFTER_CLEAR_MS,
+                   unsigned long openTimeoutMs = APPROACH_OPEN_TIMEOUT_MS);
+    
+    // Depuis le callback de l'estimateur : aucun appel bloquant
+    void requestOpen();
+    // Depuis loop(), hors de la lecture capteur
+    void update(unsigned long now);
+    
+    bool isActive() const;
+    const Stats& getStats() const;
+};
+
+#endif
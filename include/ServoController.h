@@ -3,23 +3,33 @@
 
 #include <Arduino.h>
 #include <ESP32Servo.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 class ServoController {
 private:
     Servo servo;
     int servoPin;
-    bool isOpen;
+    volatile bool isOpen;
+    volatile bool moving;
     int openAngle;
     int closedAngle;
+    int deadlineId;
+    SemaphoreHandle_t moveLock;
+    
+    // Mouvements sérialisés : appelés depuis loop() et depuis la tâche AsyncTCP
+    bool moveTo(int angle, bool open, bool automatic = false);
     
 public:
     ServoController(int pin, int openPos = 0, int closedPos = 95);
     bool init();
-    bool openGate();
-    bool closeGate();
+    // automatic = mouvement décidé par GateAutomation (marqué dans les traces)
+    bool openGate(bool automatic = false);
+    bool closeGate(bool automatic = false);
     bool setPosition(int angle);
     bool isGateOpen() const;
     int getCurrentAngle() const;
+    bool isMoving() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef SYSTEM_STATE_H
+#define SYSTEM_STATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <type_traits>
+
+// Instantané cohérent de l'état du système, publié par la boucle de contrôle
+// et lu par les handlers web (tâche AsyncTCP). Volontairement sans Arduino.h
+// pour pouvoir être compilé sur l'hôte (tools/seqlock_stress.cpp).
+struct SystemSnapshot {
+    uint32_t version;       // Incrémenté à chaque publication (0 = jamais publié)
+    float distanceCm;
+    bool objectDetected;
+    float approachSpeedCmS;
+    float etaMs;            // Temps estimé avant le seuil de détection (-1 = pas d'approche)
+    float approachConfidence;
+    bool gateOpen;
+    bool gateMoving;
+    int16_t gateAngle;
+    bool camReachable;      // Toutes les caméras du pool joignables
+    uint8_t camCircuit;     // CircuitBreaker::State le plus dégradé du pool
+    uint8_t camerasHealthy;
+    uint8_t camerasTotal;
+    uint32_t freeHeap;
+    uint32_t uptimeMs;
+    uint8_t controlCore;
+};
+
+static_assert(std::is_trivially_copyable<SystemSnapshot>::value, "SystemSnapshot est copié mot à mot");
+
+// Seqlock à un seul écrivain : l'écrivain ne bloque jamais, les lecteurs ne
+// prennent aucun verrou et recommencent la copie si une publication les a
+// chevauchés (séquence impaire ou modifiée pendant la lecture).
+// L'instantané est stocké en mots atomiques (accès relaxed) : une lecture
+// chevauchée rend une copie fausse mais jamais un comportement indéfini.
+class SystemState {
+private:
+    static const size_t WORDS = (sizeof(SystemSnapshot) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+    
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> words[WORDS];
+    
+public:
+    SystemState();
+    
+    // Appelé uniquement depuis la tâche de contrôle
+    void publish(const SystemSnapshot& snapshot);
+    
+    // Utilisable depuis n'importe quelle tâche, sans verrou. Les relectures
+    // sont ajoutées à *retries, compteur propre au lecteur (aucune ligne de
+    // cache partagée écrite par les lecteurs)
+    SystemSnapshot read(uint32_t* retries = nullptr) const;
+    
+    uint32_t getVersion() const;
+};
+
+#endif
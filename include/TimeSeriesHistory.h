@@ -0,0 +1,106 @@
+#ifndef TIME_SERIES_HISTORY_H
+#define TIME_SERIES_HISTORY_H
+
+#include <Arduino.h>
+#include "ESP32Config.h"
+
+struct HistoryPoint {
+    uint32_t timestampMs;
+    float value;    // Brut : valeur ; seaux : moyenne
+    float min;
+    float max;
+};
+
+typedef void (*HistoryEmitCallback)(const HistoryPoint& point, void* context);
+
+// Historique multi-résolution des métriques système, en mémoire fixe :
+//   - brut : HISTORY_RAW_POINTS échantillons de 16 octets   (~5 KB)
+//   - 1 s  : HISTORY_1S_POINTS seaux min/max/moy de 36 octets  (~6.3 KB)
+//   - 10 s : HISTORY_10S_POINTS seaux min/max/moy de 36 octets (~6.3 KB)
+// soit ~18 KB au total, alloués statiquement. add() est O(1).
+//
+// Les valeurs sont stockées en uint16 : distance en dixièmes de cm, détection
+// en pour-mille (la moyenne d'un seau donne le taux de présence), angle en
+// degrés, heap libre en unités de 16 octets, latence de boucle en ms.
+class TimeSeriesHistory {
+public:
+    enum Metric {
+        METRIC_DISTANCE,
+        METRIC_DETECTED,
+        METRIC_GATE_ANGLE,
+        METRIC_FREE_HEAP,
+        METRIC_LOOP_LATENCY,
+        METRIC_COUNT
+    };
+    
+    enum Tier {
+        TIER_RAW,
+        TIER_1S,
+        TIER_10S
+    };
+    
+private:
+    struct RawSample {
+        uint32_t timestampMs;
+        uint16_t values[METRIC_COUNT];
+    };
+    
+    struct Bucket {
+        uint32_t startMs;
+        uint16_t min[METRIC_COUNT];
+        uint16_t max[METRIC_COUNT];
+        uint16_t avg[METRIC_COUNT];
+    };
+    
+    struct Accumulator {
+        uint32_t startMs;
+        uint16_t count;
+        uint16_t min[METRIC_COUNT];
+        uint16_t max[METRIC_COUNT];
+        uint32_t sum[METRIC_COUNT];
+    };
+    
+    RawSample raw[HISTORY_RAW_POINTS];
+    Bucket buckets1s[HISTORY_1S_POINTS];
+    Bucket buckets10s[HISTORY_10S_POINTS];
+    uint16_t rawHead, rawCount;
+    uint16_t head1s, count1s;
+    uint16_t head10s, count10s;
+    Accumulator acc1s;
+    Accumulator acc10s;
+    mutable portMUX_TYPE lock;
+    
+    static void accumulate(Accumulator& acc, uint32_t startMs, const uint16_t* values, uint16_t weight);
+    static void closeBucket(const Accumulator& acc, Bucket& out);
+    static uint16_t encode(Metric metric, float value);
+    
+    uint16_t tierCapacity(Tier tier) const;
+    void tierState(Tier tier, uint16_t& head, uint16_t& count) const;
+    void pointAt(Tier tier, uint16_t oldest, uint16_t index, Metric metric, HistoryPoint& out) const;
+    
+public:
+    TimeSeriesHistory();
+    
+    // Appelé depuis loop() à chaque itération
+    void add(uint32_t nowMs, float distanceCm, bool detected, int gateAngle,
+             uint32_t freeHeap, uint32_t loopLatencyMs);
+    
+    // Résolution la plus fine dont les données retenues couvrent [now - rangeMs, now]
+    // (d'après les horodatages réels, pas la cadence supposée de loop())
+    Tier selectTier(uint32_t nowMs, uint32_t rangeMs) const;
+    
+    // Sous-échantillonne (LTTB) la fenêtre [now - rangeMs, now] du niveau
+    // tier à maxPoints points et appelle emit() pour chacun, du plus ancien
+    // au plus récent.
+    size_t query(Metric metric, Tier tier, uint32_t nowMs, uint32_t rangeMs, size_t maxPoints,
+                 HistoryEmitCallback emit, void* context) const;
+    
+    static bool metricFromName(const String& name, Metric& out);
+    static const char* metricName(Metric metric);
+    static const char* metricUnit(Metric metric);
+    static const char* tierName(Tier tier);
+    static float decode(Metric metric, uint16_t raw);
+    static size_t getMemoryBytes();
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <Arduino.h>
+
+// Format binaire des traces (little-endian, identique ESP32 / PC) :
+//   TraceHeader puis N x TraceRecord de 8 octets.
+#define TRACE_MAGIC 0x52544753UL    // "SGTR"
+#define TRACE_VERSION 1
+
+enum TraceRecordType : uint8_t {
+    TRACE_ECHO = 1,       // value = durée d'écho brute en µs (0 = timeout pulseIn)
+    TRACE_API_CALL = 2,   // value = TraceRoute
+    TRACE_GATE = 3        // value = angle, flags = TraceGateFlags
+};
+
+enum TraceGateFlags : uint8_t {
+    TRACE_GATE_OPEN = 0x01,     // Barrière ouverte après le mouvement
+    TRACE_GATE_AUTO = 0x02      // Mouvement décidé par GateAutomation (sinon API)
+};
+
+enum TraceRoute : uint16_t {
+    TRACE_ROUTE_OTHER = 0,
+    TRACE_ROUTE_ROOT,
+    TRACE_ROUTE_STATUS,
+    TRACE_ROUTE_DISTANCE,
+    TRACE_ROUTE_GATE_GET,
+    TRACE_ROUTE_GATE_POST,
+    TRACE_ROUTE_PHOTO,
+    TRACE_ROUTE_AUTO,
+    TRACE_ROUTE_ESP32CAM,
+    TRACE_ROUTE_CAPTURE,
+    TRACE_ROUTE_HISTORY,
+    TRACE_ROUTE_DIAGNOSTICS
+};
+
+struct __attribute__((packed)) TraceHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t recordCount;
+    uint32_t startMillis;
+};
+
+struct __attribute__((packed)) TraceRecord {
+    uint32_t timestampMs;
+    uint8_t type;
+    uint8_t flags;
+    uint16_t value;
+};
+
+// Enregistreur de traces capteur / API / barrière dans un tampon circulaire
+// en RAM, avec vidage optionnel vers la flash (LittleFS). Statique comme
+// DebugHelper : les points d'enregistrement sont répartis dans tout le code.
+class TraceRecorder {
+private:
+    static TraceRecord buffer[];
+    static uint16_t head;
+    static uint16_t count;
+    static uint16_t unflushed;
+    static uint32_t totalRecords;
+    static uint32_t droppedRecords;
+    static uint32_t startMillis;
+    static volatile bool recording;
+    static uint8_t pauseCount;
+    static volatile uint8_t pendingCommand;
+    static bool flashMounted;
+    static bool flashEnabled;
+    static uint32_t flashBytes;
+    static portMUX_TYPE lock;
+    
+    static void record(uint8_t type, uint8_t flags, uint16_t value);
+    static bool isPaused();
+    static void applyStart(bool toFlash);
+    static void applyStop();
+    static void applyClear();
+    static bool flushToFlash();
+    
+public:
+    // Monte LittleFS une fois au démarrage, sans toucher au fichier : une trace
+    // flash enregistrée avant un reboot reste téléchargeable
+    static void begin();
+    
+    // Demandes appliquées par service() dans loop() : les écritures LittleFS
+    // (troncature au démarrage d'un enregistrement, vidage) et le tampon de
+    // vidage restent confinés à la tâche de contrôle
+    static void start(bool toFlash = false);
+    static void stop();
+    static void clear();
+    static bool isRecording();
+    static bool hasPendingCommand();
+    // Suspend l'enregistrement pendant un téléchargement du tampon (compteur :
+    // plusieurs téléchargements simultanés ne se relancent pas l'un l'autre)
+    static void pause();
+    static void resume();
+    
+    static void recordEcho(long durationUs);
+    static void recordApiCall(TraceRoute route);
+    static void recordGate(int angle, bool open, bool automatic = false);
+    
+    // À appeler depuis loop() : applique les demandes et vide le tampon vers la flash
+    static void service();
+    
+    // Sérialisation pour le téléchargement HTTP (en-tête + enregistrements)
+    static size_t getSerializedSize();
+    static size_t serialize(uint8_t* dest, size_t offset, size_t maxLen);
+    
+    static uint16_t getBufferedCount();
+    static uint32_t getTotalRecords();
+    static uint32_t getDroppedRecords();
+    static uint32_t getFlashBytes();
+    static TraceRoute routeFromUrl(const char* url, bool isPost);
+};
+
+#endif
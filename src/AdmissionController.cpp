@@ -0,0 +1,105 @@
+#include "AdmissionController.h"
+
+AdmissionController::AdmissionController() : inFlight(0) {
+    memset(clients, 0, sizeof(clients));
+    memset(&counters, 0, sizeof(counters));
+}
+
+AdmissionController::ClientEntry* AdmissionController::findOrCreateClient(uint32_t ip, unsigned long now) {
+    ClientEntry* oldest = &clients[0];
+    
+    for (uint8_t i = 0; i < ADMISSION_MAX_CLIENTS; i++) {
+        if (clients[i].ip == ip) {
+            clients[i].lastSeen = now;
+            return &clients[i];
+        }
+        if (clients[i].ip == 0 || clients[i].lastSeen < oldest->lastSeen) {
+            oldest = &clients[i];
+            if (clients[i].ip == 0) {
+                break;
+            }
+        }
+    }
+    
+    // Table pleine : on recycle le client le moins récent avec des seaux pleins
+    oldest->ip = ip;
+    oldest->lastSeen = now;
+    oldest->buckets[READ].milliTokens = ADMISSION_READ_BURST * 1000UL;
+    oldest->buckets[READ].lastRefill = now;
+    oldest->buckets[CONTROL].milliTokens = ADMISSION_CONTROL_BURST * 1000UL;
+    oldest->buckets[CONTROL].lastRefill = now;
+    return oldest;
+}
+
+bool AdmissionController::takeToken(TokenBucket& bucket, RequestClass cls, unsigned long now) {
+    uint32_t rate = (cls == CONTROL) ? ADMISSION_CONTROL_RATE_PER_SEC : ADMISSION_READ_RATE_PER_SEC;
+    uint32_t capacity = ((cls == CONTROL) ? ADMISSION_CONTROL_BURST : ADMISSION_READ_BURST) * 1000UL;
+    
+    // rate jetons/s == rate milli-jetons/ms
+    unsigned long elapsed = now - bucket.lastRefill;
+    uint32_t refill = (elapsed > capacity) ? capacity : elapsed * rate;
+    bucket.milliTokens = min(capacity, bucket.milliTokens + refill);
+    bucket.lastRefill = now;
+    
+    if (bucket.milliTokens < 1000) {
+        return false;
+    }
+    bucket.milliTokens -= 1000;
+    return true;
+}
+
+AdmissionController::Decision AdmissionController::admit(uint32_t clientIP, RequestClass cls, uint32_t freeHeap) {
+    // Vérifications les moins coûteuses d'abord, sans aucune allocation
+    if (freeHeap < ADMISSION_HEAP_CRITICAL ||
+        (cls == READ && freeHeap < ADMISSION_HEAP_WATERMARK)) {
+        counters.lowMemory++;
+        return LOW_MEMORY;
+    }
+    
+    // Les lectures ne peuvent pas occuper les places réservées au contrôle
+    uint8_t limit = (cls == CONTROL) ? ADMISSION_MAX_INFLIGHT
+                                     : ADMISSION_MAX_INFLIGHT - ADMISSION_CONTROL_RESERVED;
+    if (inFlight >= limit) {
+        counters.overloaded++;
+        return OVERLOADED;
+    }
+    
+    unsigned long now = millis();
+    ClientEntry* client = findOrCreateClient(clientIP, now);
+    if (!takeToken(client->buckets[cls], cls, now)) {
+        counters.rateLimited++;
+        return RATE_LIMITED;
+    }
+    
+    inFlight++;
+    counters.admitted++;
+    return ADMITTED;
+}
+
+void AdmissionController::release() {
+    if (inFlight > 0) {
+        inFlight--;
+    }
+}
+
+uint8_t AdmissionController::getInFlight() const {
+    return inFlight;
+}
+
+const AdmissionController::Counters& AdmissionController::getCounters() const {
+    return counters;
+}
+
+uint32_t AdmissionController::getShedTotal() const {
+    return counters.rateLimited + counters.overloaded + counters.lowMemory;
+}
+
+const char* AdmissionController::decisionToString(Decision d) {
+    switch (d) {
+        case ADMITTED: return "ADMITTED";
+        case RATE_LIMITED: return "RATE_LIMITED";
+        case OVERLOADED: return "OVERLOADED";
+        case LOW_MEMORY: return "LOW_MEMORY";
+        default: return "UNKNOWN";
+    }
+}
@@ -0,0 +1,128 @@
+#include "ApproachEstimator.h"
+#include "ESP32Config.h"
+
+ApproachEstimator::ApproachEstimator(float a, float b)
+    : alpha(a), beta(b), position(0), velocity(0), residualVar(0), lastSampleMs(0), samples(0),
+      consecutiveOutliers(0),
+      callback(nullptr), callbackThresholdCm(0), callbackLeadMs(0), callbackMinConfidence(0),
+      callbackFired(false) {
+}
+
+void ApproachEstimator::reset() {
+    position = 0;
+    velocity = 0;
+    residualVar = 0;
+    samples = 0;
+    consecutiveOutliers = 0;
+    callbackFired = false;
+}
+
+void ApproachEstimator::update(float distanceCm, unsigned long nowMs) {
+    unsigned long gap = nowMs - lastSampleMs;
+    
+    // Premier échantillon ou flux interrompu : on repart de la mesure
+    if (samples == 0 || gap == 0 || gap > APPROACH_RESET_GAP_MS) {
+        reset();
+        position = distanceCm;
+        lastSampleMs = nowMs;
+        samples = 1;
+        return;
+    }
+    
+    float dt = gap / 1000.0f;
+    
+    // Deuxième échantillon : vitesse initialisée par différence finie
+    if (samples == 1) {
+        velocity = (distanceCm - position) / dt;
+        position = distanceCm;
+        lastSampleMs = nowMs;
+        samples = 2;
+        return;
+    }
+    
+    float predicted = position + velocity * dt;
+    float residual = distanceCm - predicted;
+    
+    // Écho aberrant (reflet, autre objet) : ignoré sauf s'il persiste
+    if (fabsf(residual) > APPROACH_OUTLIER_CM) {
+        if (++consecutiveOutliers < APPROACH_MAX_OUTLIERS) {
+            return;
+        }
+        reset();
+        position = distanceCm;
+        lastSampleMs = nowMs;
+        samples = 1;
+        return;
+    }
+    consecutiveOutliers = 0;
+    
+    position = predicted + alpha * residual;
+    velocity = velocity + (beta / dt) * residual;
+    residualVar = 0.8f * residualVar + 0.2f * residual * residual;
+    lastSampleMs = nowMs;
+    if (samples < 0xFFFF) {
+        samples++;
+    }
+    
+    checkCallback();
+}
+
+float ApproachEstimator::getPosition() const {
+    return position;
+}
+
+float ApproachEstimator::getVelocity() const {
+    return velocity;
+}
+
+float ApproachEstimator::getApproachSpeed() const {
+    return velocity < -APPROACH_MIN_SPEED_CM_S ? -velocity : 0.0f;
+}
+
+float ApproachEstimator::getConfidence() const {
+    if (samples < 2) {
+        return 0.0f;
+    }
+    float warmup = min(1.0f, (samples - 1) / (float)(APPROACH_CONFIDENCE_SAMPLES - 1));
+    return warmup * expf(-sqrtf(residualVar) / APPROACH_RESIDUAL_SCALE_CM);
+}
+
+float ApproachEstimator::getTimeToThresholdMs(float thresholdCm) const {
+    if (samples == 0) {
+        return -1.0f;
+    }
+    if (position <= thresholdCm) {
+        return 0.0f;
+    }
+    float speed = getApproachSpeed();
+    if (speed <= 0.0f) {
+        return -1.0f;
+    }
+    return (position - thresholdCm) / speed * 1000.0f;
+}
+
+void ApproachEstimator::setApproachCallback(ApproachCallback cb, float thresholdCm,
+                                            unsigned long leadMs, float minConfidence) {
+    callback = cb;
+    callbackThresholdCm = thresholdCm;
+    callbackLeadMs = leadMs;
+    callbackMinConfidence = minConfidence;
+    callbackFired = false;
+}
+
+void ApproachEstimator::checkCallback() {
+    if (!callback) return;
+    
+    float eta = getTimeToThresholdMs(callbackThresholdCm);
+    
+    // Réarmement quand l'objet s'éloigne ou s'arrête hors du seuil
+    if (eta < 0) {
+        callbackFired = false;
+        return;
+    }
+    
+    if (!callbackFired && eta <= callbackLeadMs && getConfidence() >= callbackMinConfidence) {
+        callbackFired = true;
+        callback(eta, getApproachSpeed(), getConfidence());
+    }
+}
@@ -0,0 +1,267 @@
+#include "CameraPool.h"
+
+CameraPool::CameraPool() : cameraCount(0), doneBits(nullptr), roundCommand(CMD_PROBE),
+                           roundDeadline(0), remaining(0), capturePending(false),
+                           captureRequestedAt(0) {
+    lock = portMUX_INITIALIZER_UNLOCKED;
+    memset(slots, 0, sizeof(slots));
+    memset(&round, 0, sizeof(round));
+}
+
+bool CameraPool::addCamera(const char* name, ESP32CAMClient* client) {
+    if (cameraCount >= CAMERA_POOL_MAX || doneBits != nullptr) {
+        Serial.printf("❌ Camera pool: cannot add %s\n", name);
+        return false;
+    }
+    
+    CameraSlot& slot = slots[cameraCount];
+    slot.name = name;
+    slot.deadlineId = -1;
+    slot.client = client;
+    slot.pool = this;
+    slot.index = cameraCount;
+    cameraCount++;
+    return true;
+}
+
+bool CameraPool::begin() {
+    doneBits = xEventGroupCreate();
+    if (doneBits == nullptr) {
+        Serial.println("❌ Camera pool: event group allocation failed");
+        return false;
+    }
+    
+    for (uint8_t i = 0; i < cameraCount; i++) {
+        snprintf(slots[i].taskName, sizeof(slots[i].taskName), "cam_%s", slots[i].name);
+        slots[i].deadlineId = DeadlineMonitor::registerTask(slots[i].taskName, DEADLINE_CAMERA_MS);
+        
+        BaseType_t created = xTaskCreatePinnedToCore(workerTask, slots[i].taskName, CAMERA_TASK_STACK,
+                                                     &slots[i], 1, &slots[i].task, CAMERA_TASK_CORE);
+        if (created != pdPASS) {
+            Serial.printf("❌ Camera pool: failed to start task for %s\n", slots[i].name);
+            return false;
+        }
+        Serial.printf("📷 Camera '%s' at %s (task on core %d)\n",
+                      slots[i].name, slots[i].client->getIP().c_str(), CAMERA_TASK_CORE);
+    }
+    return true;
+}
+
+void CameraPool::workerTask(void* param) {
+    CameraSlot* slot = static_cast<CameraSlot*>(param);
+    
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        slot->pool->runCommand(*slot);
+    }
+}
+
+void CameraPool::runCommand(CameraSlot& slot) {
+    unsigned long start = millis();
+    bool ok;
+    
+    DeadlineMonitor::begin(slot.deadlineId);
+    if (roundCommand == CMD_CAPTURE) {
+        ok = slot.client->requestPhoto(roundDeadline);
+    } else {
+        ok = slot.client->isReachable(roundDeadline);
+    }
+    DeadlineMonitor::end(slot.deadlineId);
+    
+    unsigned long now = millis();
+    CameraResult result = { ok, (uint32_t)(now - start), (uint32_t)now };
+    
+    portENTER_CRITICAL(&lock);
+    if (roundCommand == CMD_CAPTURE) {
+        slot.lastCapture = result;
+    } else {
+        slot.lastProbe = result;
+    }
+    // Une capture réussie prouve aussi que la caméra est joignable
+    if (ok || roundCommand == CMD_PROBE) {
+        slot.reachable = ok;
+    }
+    if (ok) {
+        round.succeeded++;
+    }
+    // La dernière caméra à répondre clôt la ronde
+    if (--remaining == 0) {
+        round.inProgress = false;
+        round.latencyMs = now - round.startedAt;
+    }
+    portEXIT_CRITICAL(&lock);
+    
+    xEventGroupSetBits(doneBits, 1 << slot.index);
+}
+
+EventBits_t CameraPool::allBits() const {
+    return (1 << cameraCount) - 1;
+}
+
+void CameraPool::beginRoundLocked(Command command, unsigned long now, uint32_t queuedMs) {
+    round.id++;
+    round.command = command;
+    round.inProgress = true;
+    round.startedAt = now;
+    round.queuedMs = queuedMs;
+    round.latencyMs = 0;
+    round.succeeded = 0;
+    round.cameras = cameraCount;
+    roundCommand = command;
+    roundDeadline = now + (command == CMD_CAPTURE ? CAM_PHOTO_TIMEOUT_MS : CAM_REACHABLE_TIMEOUT_MS);
+    remaining = cameraCount;
+}
+
+void CameraPool::dispatchRound() {
+    xEventGroupClearBits(doneBits, allBits());
+    for (uint8_t i = 0; i < cameraCount; i++) {
+        xTaskNotifyGive(slots[i].task);
+    }
+}
+
+CameraPool::TriggerResult CameraPool::triggerCapture(uint32_t* roundId) {
+    if (doneBits == nullptr || cameraCount == 0) {
+        return TRIGGER_UNAVAILABLE;
+    }
+    
+    TriggerResult result;
+    portENTER_CRITICAL(&lock);
+    if (capturePending || (round.inProgress && round.command == CMD_CAPTURE)) {
+        result = TRIGGER_BUSY;
+    } else if (round.inProgress) {
+        // Sondage en cours : service() lancera la capture dès sa fin
+        capturePending = true;
+        captureRequestedAt = millis();
+        result = TRIGGER_QUEUED;
+    } else {
+        beginRoundLocked(CMD_CAPTURE, millis(), 0);
+        result = TRIGGER_STARTED;
+    }
+    if (roundId) {
+        *roundId = result == TRIGGER_QUEUED ? round.id + 1 : round.id;
+    }
+    portEXIT_CRITICAL(&lock);
+    
+    if (result == TRIGGER_STARTED) {
+        dispatchRound();
+    }
+    return result;
+}
+
+bool CameraPool::triggerProbe() {
+    if (doneBits == nullptr || cameraCount == 0) {
+        return false;
+    }
+    
+    portENTER_CRITICAL(&lock);
+    // Une capture en attente passe avant le sondage suivant
+    if (round.inProgress || capturePending) {
+        portEXIT_CRITICAL(&lock);
+        return false;
+    }
+    beginRoundLocked(CMD_PROBE, millis(), 0);
+    portEXIT_CRITICAL(&lock);
+    
+    dispatchRound();
+    return true;
+}
+
+void CameraPool::service() {
+    if (doneBits == nullptr) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&lock);
+    bool start = capturePending && !round.inProgress;
+    if (start) {
+        unsigned long now = millis();
+        capturePending = false;
+        beginRoundLocked(CMD_CAPTURE, now, now - captureRequestedAt);
+    }
+    portEXIT_CRITICAL(&lock);
+    
+    if (start) {
+        dispatchRound();
+    }
+}
+
+bool CameraPool::waitForRound(unsigned long timeoutMs) {
+    if (doneBits == nullptr) {
+        return false;
+    }
+    EventBits_t bits = xEventGroupWaitBits(doneBits, allBits(), pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeoutMs));
+    return (bits & allBits()) == allBits();
+}
+
+uint8_t CameraPool::getCameraCount() const {
+    return cameraCount;
+}
+
+uint8_t CameraPool::getHealthyCount() {
+    uint8_t healthy = 0;
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < cameraCount; i++) {
+        if (slots[i].reachable) {
+            healthy++;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+    return healthy;
+}
+
+ESP32CAMClient* CameraPool::getCamera(uint8_t index) {
+    return index < cameraCount ? slots[index].client : nullptr;
+}
+
+const char* CameraPool::getCameraName(uint8_t index) const {
+    return index < cameraCount ? slots[index].name : "";
+}
+
+bool CameraPool::isReachable(uint8_t index) {
+    portENTER_CRITICAL(&lock);
+    bool reachable = index < cameraCount && slots[index].reachable;
+    portEXIT_CRITICAL(&lock);
+    return reachable;
+}
+
+CameraPool::CameraResult CameraPool::getLastCapture(uint8_t index) {
+    CameraResult result = { false, 0, 0 };
+    portENTER_CRITICAL(&lock);
+    if (index < cameraCount) {
+        result = slots[index].lastCapture;
+    }
+    portEXIT_CRITICAL(&lock);
+    return result;
+}
+
+CameraPool::CameraResult CameraPool::getLastProbe(uint8_t index) {
+    CameraResult result = { false, 0, 0 };
+    portENTER_CRITICAL(&lock);
+    if (index < cameraCount) {
+        result = slots[index].lastProbe;
+    }
+    portEXIT_CRITICAL(&lock);
+    return result;
+}
+
+CameraPool::RoundInfo CameraPool::getLastRound() {
+    portENTER_CRITICAL(&lock);
+    RoundInfo info = round;
+    portEXIT_CRITICAL(&lock);
+    return info;
+}
+
+CircuitBreaker::State CameraPool::getWorstCircuit() {
+    CircuitBreaker::State worst = CircuitBreaker::CLOSED;
+    for (uint8_t i = 0; i < cameraCount; i++) {
+        CircuitBreaker::State s = slots[i].client->getBreaker().getState();
+        if (s == CircuitBreaker::OPEN) {
+            return CircuitBreaker::OPEN;
+        }
+        if (s == CircuitBreaker::HALF_OPEN) {
+            worst = CircuitBreaker::HALF_OPEN;
+        }
+    }
+    return worst;
+}
@@ -0,0 +1,141 @@
+#include "CircuitBreaker.h"
+
+CircuitBreaker::CircuitBreaker(uint8_t failures, unsigned long openMs, uint8_t probes)
+    : state(CLOSED), failureThreshold(failures), halfOpenMaxProbes(probes),
+      openDurationMs(openMs), consecutiveFailures(0), probesInFlight(0), openedAt(0), episodeStart(0),
+      lastRecoveryMs(0), fastFailCount(0), tripCount(0) {
+    lock = portMUX_INITIALIZER_UNLOCKED;
+}
+
+bool CircuitBreaker::allowRequest() {
+    unsigned long now = millis();
+    bool allowed = false;
+    
+    portENTER_CRITICAL(&lock);
+    if (state == OPEN && now - openedAt >= openDurationMs) {
+        state = HALF_OPEN;
+        probesInFlight = 0;
+    }
+    
+    if (state == CLOSED) {
+        allowed = true;
+    } else if (state == HALF_OPEN && probesInFlight < halfOpenMaxProbes) {
+        probesInFlight++;
+        allowed = true;
+    } else {
+        fastFailCount++;
+    }
+    portEXIT_CRITICAL(&lock);
+    
+    return allowed;
+}
+
+void CircuitBreaker::recordSuccess() {
+    unsigned long now = millis();
+    bool recovered = false;
+    
+    portENTER_CRITICAL(&lock);
+    if (state == HALF_OPEN) {
+        lastRecoveryMs = now - episodeStart;
+        recovered = true;
+    }
+    state = CLOSED;
+    consecutiveFailures = 0;
+    probesInFlight = 0;
+    portEXIT_CRITICAL(&lock);
+    
+    if (recovered) {
+        Serial.printf("✅ Circuit CLOSED (recovered after %lu ms)\n", lastRecoveryMs);
+    }
+}
+
+void CircuitBreaker::recordFailure() {
+    unsigned long now = millis();
+    bool tripped = false;
+    
+    portENTER_CRITICAL(&lock);
+    if (consecutiveFailures < 255) {
+        consecutiveFailures++;
+    }
+    // Un échec en half-open rouvre immédiatement le circuit
+    if (state == HALF_OPEN || (state == CLOSED && consecutiveFailures >= failureThreshold)) {
+        tripLocked(now);
+        tripped = true;
+    }
+    portEXIT_CRITICAL(&lock);
+    
+    if (tripped) {
+        Serial.printf("⛔ Circuit OPEN after %d failures (retry in %lu ms)\n",
+                      consecutiveFailures, openDurationMs);
+    }
+}
+
+void CircuitBreaker::tripLocked(unsigned long now) {
+    // Garder le début de l'épisode pour mesurer le temps de récupération total
+    if (state == CLOSED) {
+        tripCount++;
+        episodeStart = now;
+    }
+    openedAt = now;
+    state = OPEN;
+    probesInFlight = 0;
+}
+
+void CircuitBreaker::reset() {
+    portENTER_CRITICAL(&lock);
+    state = CLOSED;
+    consecutiveFailures = 0;
+    probesInFlight = 0;
+    portEXIT_CRITICAL(&lock);
+}
+
+CircuitBreaker::State CircuitBreaker::getState() {
+    unsigned long now = millis();
+    portENTER_CRITICAL(&lock);
+    State current = state;
+    if (current == OPEN && now - openedAt >= openDurationMs) {
+        current = HALF_OPEN;
+    }
+    portEXIT_CRITICAL(&lock);
+    return current;
+}
+
+const char* CircuitBreaker::getStateString() {
+    return stateToString(getState());
+}
+
+uint8_t CircuitBreaker::getConsecutiveFailures() const {
+    return consecutiveFailures;
+}
+
+uint32_t CircuitBreaker::getFastFailCount() const {
+    return fastFailCount;
+}
+
+uint32_t CircuitBreaker::getTripCount() const {
+    return tripCount;
+}
+
+unsigned long CircuitBreaker::getLastRecoveryMs() const {
+    return lastRecoveryMs;
+}
+
+unsigned long CircuitBreaker::getRetryInMs() {
+    unsigned long now = millis();
+    unsigned long remaining = 0;
+    portENTER_CRITICAL(&lock);
+    if (state == OPEN && now - openedAt < openDurationMs) {
+        remaining = openDurationMs - (now - openedAt);
+    }
+    portEXIT_CRITICAL(&lock);
+    return remaining;
+}
+
+const char* CircuitBreaker::stateToString(State s) {
+    switch (s) {
+        case CLOSED: return "CLOSED";
+        case OPEN: return "OPEN";
+        case HALF_OPEN: return "HALF_OPEN";
+        default: return "UNKNOWN";
+    }
+}
@@ -0,0 +1,258 @@
+#include "DeadlineMonitor.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_attr.h>
+#include <esp_timer.h>
+#include "DebugHelper.h"
+#else
+#define RTC_NOINIT_ATTR
+#endif
+
+#define DEADLINE_RTC_MAGIC 0x444C4D31  // "DLM1"
+
+// Un blocage de loop() doit être persisté par le superviseur avant que le
+// watchdog matériel ne redémarre la carte
+static_assert(DEADLINE_LOOP_MS * DEADLINE_HANG_FACTOR + DEADLINE_CHECK_INTERVAL_MS < DEADLINE_WDT_TIMEOUT_S * 1000UL,
+              "loop hang limit must expire before the task watchdog");
+
+// Mémoire RTC non initialisée : survit aux resets logiciels et watchdog,
+// pas à une coupure d'alimentation (le magic détecte alors le contenu aléatoire)
+struct PersistedOverruns {
+    uint32_t magic;
+    uint32_t bootCount;
+    uint8_t head;
+    uint8_t count;
+    OverrunRecord records[DEADLINE_PERSISTED_OVERRUNS];
+};
+
+RTC_NOINIT_ATTR static PersistedOverruns persisted;
+
+DeadlineMonitor::TaskInfo DeadlineMonitor::tasks[DEADLINE_MAX_TASKS];
+uint8_t DeadlineMonitor::taskCount = 0;
+volatile bool DeadlineMonitor::healthy = true;
+bool DeadlineMonitor::supervised = false;
+uint32_t DeadlineMonitor::checkpoints = 0;
+portMUX_TYPE DeadlineMonitor::lock = portMUX_INITIALIZER_UNLOCKED;
+
+void DeadlineMonitor::init() {
+    if (persisted.magic != DEADLINE_RTC_MAGIC ||
+        persisted.count > DEADLINE_PERSISTED_OVERRUNS ||
+        persisted.head >= DEADLINE_PERSISTED_OVERRUNS) {
+        memset(&persisted, 0, sizeof(persisted));
+        persisted.magic = DEADLINE_RTC_MAGIC;
+    }
+    persisted.bootCount++;
+    
+    taskCount = 0;
+    healthy = true;
+    checkpoints = 0;
+    
+    Serial.printf("✅ Deadline monitor initialized (boot #%u, %u dépassement(s) persisté(s))\n",
+                  (unsigned)persisted.bootCount, (unsigned)persisted.count);
+    if (persisted.count > 0) {
+        printPersisted();
+    }
+}
+
+int DeadlineMonitor::registerTask(const char* name, uint32_t budgetMs, uint32_t hangMs) {
+    portENTER_CRITICAL(&lock);
+    if (taskCount >= DEADLINE_MAX_TASKS) {
+        portEXIT_CRITICAL(&lock);
+        Serial.printf("❌ Deadline monitor: table pleine, %s non surveillé\n", name);
+        return -1;
+    }
+    int id = taskCount++;
+    TaskInfo& task = tasks[id];
+    task.name = name;
+    task.budgetMs = budgetMs;
+    task.hangMs = hangMs > 0 ? hangMs : budgetMs * DEADLINE_HANG_FACTOR;
+    task.startedAt = 0;
+    task.active = false;
+    task.lastMs = 0;
+    task.maxMs = 0;
+    task.overruns = 0;
+    task.hangReported = false;
+    portEXIT_CRITICAL(&lock);
+    return id;
+}
+
+void DeadlineMonitor::begin(int id) {
+    if (id < 0 || id >= taskCount) return;
+    
+    uint32_t now = millis();
+    portENTER_CRITICAL(&lock);
+    tasks[id].startedAt = now;
+    tasks[id].active = true;
+    tasks[id].hangReported = false;
+    checkpoints++;
+    portEXIT_CRITICAL(&lock);
+}
+
+void DeadlineMonitor::end(int id) {
+    if (id < 0 || id >= taskCount) return;
+    
+    uint32_t now = millis();
+    bool overrun = false;
+    bool alreadyReported = false;
+    uint32_t duration = 0;
+    
+    portENTER_CRITICAL(&lock);
+    TaskInfo& task = tasks[id];
+    if (task.active) {
+        duration = now - task.startedAt;
+        task.active = false;
+        task.lastMs = duration;
+        if (duration > task.maxMs) {
+            task.maxMs = duration;
+        }
+        if (duration > task.budgetMs) {
+            task.overruns++;
+            overrun = true;
+            alreadyReported = task.hangReported;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+    
+    // Un blocage déjà signalé par check() n'est pas enregistré une seconde fois
+    if (overrun && !alreadyReported) {
+        recordOverrun(task, duration, false);
+        Serial.printf("⏱️ Échéance dépassée: %s %ums (budget %ums)\n",
+                      task.name, (unsigned)duration, (unsigned)task.budgetMs);
+    }
+}
+
+void DeadlineMonitor::recordOverrun(const TaskInfo& task, uint32_t durationMs, bool ongoing) {
+    portENTER_CRITICAL(&lock);
+    OverrunRecord& rec = persisted.records[persisted.head];
+    strncpy(rec.name, task.name, sizeof(rec.name) - 1);
+    rec.name[sizeof(rec.name) - 1] = '\0';
+    rec.durationMs = durationMs;
+    rec.budgetMs = task.budgetMs;
+    rec.uptimeMs = millis();
+    rec.boot = persisted.bootCount;
+    rec.ongoing = ongoing ? 1 : 0;
+    persisted.head = (persisted.head + 1) % DEADLINE_PERSISTED_OVERRUNS;
+    if (persisted.count < DEADLINE_PERSISTED_OVERRUNS) {
+        persisted.count++;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+bool DeadlineMonitor::check() {
+    uint32_t now = millis();
+    bool allHealthy = true;
+    
+    for (uint8_t i = 0; i < taskCount; i++) {
+        TaskInfo& task = tasks[i];
+        
+        portENTER_CRITICAL(&lock);
+        bool active = task.active;
+        uint32_t elapsed = now - task.startedAt;
+        bool report = active && elapsed > task.hangMs && !task.hangReported;
+        if (report) {
+            task.hangReported = true;
+        }
+        portEXIT_CRITICAL(&lock);
+        
+        if (active && elapsed > task.hangMs) {
+            allHealthy = false;
+        }
+        // Enregistré avant le reset : c'est ce qui restera lisible au boot suivant
+        if (report) {
+            recordOverrun(task, elapsed, true);
+            Serial.printf("🚨 Opération bloquée: %s depuis %ums (budget %ums) - watchdog non alimenté\n",
+                          task.name, (unsigned)elapsed, (unsigned)task.budgetMs);
+        }
+    }
+    
+    healthy = allHealthy;
+    return allHealthy;
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+static void supervisorTick(void*) {
+    DeadlineMonitor::check();
+}
+#endif
+
+bool DeadlineMonitor::startSupervisor() {
+#ifdef ARDUINO_ARCH_ESP32
+    static esp_timer_handle_t timer = nullptr;
+    if (timer != nullptr) return true;
+    
+    esp_timer_create_args_t args = {};
+    args.callback = supervisorTick;
+    args.name = "deadline";
+    if (esp_timer_create(&args, &timer) != ESP_OK ||
+        esp_timer_start_periodic(timer, DEADLINE_CHECK_INTERVAL_MS * 1000ULL) != ESP_OK) {
+        Serial.println("❌ Deadline monitor: supervisor timer failed, checks from loop() only");
+        return false;
+    }
+    supervised = true;
+    Serial.printf("✅ Deadline supervisor every %d ms\n", DEADLINE_CHECK_INTERVAL_MS);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool DeadlineMonitor::feedIfHealthy() {
+    // Sans superviseur (hôte, échec du timer), la vérification se fait ici
+    if (!supervised) {
+        check();
+    }
+    if (!healthy) {
+        return false;
+    }
+#ifdef ARDUINO_ARCH_ESP32
+    DebugHelper::feedWatchdog();
+#endif
+    return true;
+}
+
+bool DeadlineMonitor::isHealthy() {
+    return healthy;
+}
+
+uint8_t DeadlineMonitor::getTaskCount() {
+    return taskCount;
+}
+
+const DeadlineMonitor::TaskInfo& DeadlineMonitor::getTask(uint8_t index) {
+    return tasks[index < taskCount ? index : 0];
+}
+
+uint32_t DeadlineMonitor::getCheckpointCount() {
+    return checkpoints;
+}
+
+uint32_t DeadlineMonitor::getBootCount() {
+    return persisted.bootCount;
+}
+
+uint8_t DeadlineMonitor::getPersistedCount() {
+    return persisted.count;
+}
+
+OverrunRecord DeadlineMonitor::getPersisted(uint8_t index) {
+    OverrunRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    if (index >= persisted.count) return rec;
+    
+    portENTER_CRITICAL(&lock);
+    uint8_t slot = (persisted.head + DEADLINE_PERSISTED_OVERRUNS - 1 - index) % DEADLINE_PERSISTED_OVERRUNS;
+    rec = persisted.records[slot];
+    portEXIT_CRITICAL(&lock);
+    return rec;
+}
+
+void DeadlineMonitor::printPersisted() {
+    Serial.println("⏱️ Derniers dépassements d'échéance:");
+    for (uint8_t i = 0; i < persisted.count; i++) {
+        OverrunRecord rec = getPersisted(i);
+        Serial.printf("   boot #%u @%ums: %s %ums / budget %ums%s\n",
+                      (unsigned)rec.boot, (unsigned)rec.uptimeMs, rec.name,
+                      (unsigned)rec.durationMs, (unsigned)rec.budgetMs,
+                      rec.ongoing ? " (bloqué)" : "");
+    }
+}
@@ -18,7 +18,7 @@ void DebugHelper::init() {
     printSystemInfo();
     
     // Configurer le watchdog avec un délai plus long
-    esp_task_wdt_init(30, true); // 30 secondes timeout
+    esp_task_wdt_init(DEADLINE_WDT_TIMEOUT_S, true); // 30 secondes timeout
     esp_task_wdt_add(NULL);
     
     Serial.println("✅ Debug Helper initialized");
@@ -122,8 +122,8 @@ void DebugHelper::feedWatchdog() {
 }
 
 void DebugHelper::logCriticalOperation(const char* operation) {
+    // N'alimente plus le watchdog : c'est le rôle de DeadlineMonitor::feedIfHealthy()
     Serial.printf("🔧 Critical Operation: %s (Heap: %d)\n", operation, ESP.getFreeHeap());
-    feedWatchdog();
 }
 
 void DebugHelper::printStackHighWaterMark() {
@@ -1,7 +1,9 @@
 #include "DistanceSensor.h"
+#include "TraceRecorder.h"
+#include "DeadlineMonitor.h"
 
 DistanceSensor::DistanceSensor(int trig, int echo) 
-    : trigPin(trig), echoPin(echo), lastDistance(0.0), lastReadTime(0) {
+    : trigPin(trig), echoPin(echo), lastDistance(0.0), lastReadTime(0), deadlineId(-1) {
 }
 
 bool DistanceSensor::init() {
@@ -12,11 +14,14 @@ bool DistanceSensor::init() {
     digitalWrite(trigPin, LOW);
     delay(10);
     
+    deadlineId = DeadlineMonitor::registerTask("sensor", DEADLINE_SENSOR_MS);
+    
     Serial.println("Distance sensor initialized");
     return true;
 }
 
 float DistanceSensor::readDistance() {
+    DeadlineScope deadline(deadlineId);
     digitalWrite(trigPin, LOW);
     delayMicroseconds(2);
     digitalWrite(trigPin, HIGH);
@@ -25,7 +30,12 @@ float DistanceSensor::readDistance() {
     
     // Timeout très court pour éviter les blocages
     long duration = pulseIn(echoPin, HIGH, 15000); // Timeout 15ms au lieu de 30ms
+    TraceRecorder::recordEcho(duration);
     
+    return processEcho(duration);
+}
+
+float DistanceSensor::processEcho(long duration) {
     if (duration == 0) {
         // En cas d'erreur, garder la dernière valeur valide
         return lastDistance > 0 ? lastDistance : 999.0;
@@ -37,6 +47,7 @@ float DistanceSensor::readDistance() {
     if (distance > 2 && distance < 400) {
         lastDistance = distance;
         lastReadTime = millis();
+        estimator.update(distance, lastReadTime);
         return distance;
     }
     
@@ -48,6 +59,10 @@ float DistanceSensor::getLastDistance() const {
     return lastDistance;
 }
 
+unsigned long DistanceSensor::getLastValidReadTime() const {
+    return lastReadTime;
+}
+
 bool DistanceSensor::isObjectDetected(float thresholdCm) {
     return (lastDistance > 0 && lastDistance < thresholdCm);
 }
@@ -60,3 +75,7 @@ void DistanceSensor::update() {
         yield(); // Donner du temps au watchdog
     }
 }
+
+ApproachEstimator& DistanceSensor::getEstimator() {
+    return estimator;
+}
@@ -1,16 +1,45 @@
 #include "ESP32APIServer.h"
 #include "ESP32Config.h"
 #include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "TraceRecorder.h"
+#include "DebugHelper.h"
+
+struct HistoryStreamContext {
+    AsyncResponseStream *stream;
+    bool rawTier;
+    size_t written;
+};
+
+// Écrit un point d'historique directement dans le flux de réponse
+static void emitHistoryPoint(const HistoryPoint& point, void* context) {
+    HistoryStreamContext *ctx = static_cast<HistoryStreamContext*>(context);
+    const char* sep = ctx->written++ ? "," : "";
+    if (ctx->rawTier) {
+        ctx->stream->printf("%s[%u,%.2f]", sep, point.timestampMs, point.value);
+    } else {
+        ctx->stream->printf("%s[%u,%.2f,%.2f,%.2f]", sep, point.timestampMs,
+                            point.value, point.min, point.max);
+    }
+}
 
 ESP32APIServer::ESP32APIServer(int port) 
     : server(port), distanceSensor(nullptr), servoController(nullptr), 
-      camClient(nullptr), autoPhotoEnabled(false), lastAutoPhoto(0) {
+      cameraPool(nullptr), systemState(nullptr), history(nullptr), autoPhotoEnabled(false), lastAutoPhoto(0),
+      readDeadlineId(-1), controlDeadlineId(-1) {
 }
 
-bool ESP32APIServer::init(DistanceSensor* sensor, ServoController* servo, ESP32CAMClient* cam) {
+bool ESP32APIServer::init(DistanceSensor* sensor, ServoController* servo, CameraPool* cameras, SystemState* state,
+                          TimeSeriesHistory* hist) {
     distanceSensor = sensor;
     servoController = servo;
-    camClient = cam;
+    cameraPool = cameras;
+    systemState = state;
+    history = hist;
+    
+    // Handlers exécutés dans la tâche AsyncTCP ; le contrôle inclut un mouvement servo
+    readDeadlineId = DeadlineMonitor::registerTask("web_read", DEADLINE_WEB_MS);
+    controlDeadlineId = DeadlineMonitor::registerTask("web_ctl", DEADLINE_WEB_MS + DEADLINE_SERVO_MS);
     
     // Connecter WiFi
     WiFi.mode(WIFI_STA);
@@ -38,19 +67,36 @@ bool ESP32APIServer::init(DistanceSensor* sensor, ServoController* servo, ESP32C
 void ESP32APIServer::setupRoutes() {
     // Page d'accueil
     server.on("/", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::READ)) return;
+        DeadlineScope deadline(readDeadlineId);
+        
         request->send(200, "text/html", generateWebInterface());
     });
     
+    // Les handlers tournent dans la tâche AsyncTCP : ils lisent l'instantané
+    // publié par la boucle de contrôle au lieu des objets matériels.
+    
     // API Status général
     server.on("/api/status", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::READ)) return;
+        DeadlineScope deadline(readDeadlineId);
+        
+        SystemSnapshot state = systemState->read();
+        
         StaticJsonDocument<512> doc;
-        doc["distance"] = distanceSensor->getLastDistance();
-        doc["gate"] = servoController->isGateOpen();
+        doc["distance"] = state.distanceCm;
+        doc["gate"] = state.gateOpen;
+        doc["gate_moving"] = state.gateMoving;
         doc["auto_photo"] = autoPhotoEnabled;
-        doc["esp32cam_ip"] = camClient->getIP();
-        doc["esp32cam_reachable"] = camClient->isReachable();
-        doc["free_heap"] = ESP.getFreeHeap();
-        doc["uptime"] = millis();
+        doc["esp32cam_ip"] = cameraPool->getCamera(0)->getIP();
+        doc["esp32cam_reachable"] = state.camReachable;
+        doc["cameras"] = state.camerasTotal;
+        doc["cameras_healthy"] = state.camerasHealthy;
+        doc["esp32cam_circuit"] = CircuitBreaker::stateToString((CircuitBreaker::State)state.camCircuit);
+        doc["free_heap"] = state.freeHeap;
+        doc["uptime"] = state.uptimeMs;
+        doc["state_version"] = state.version;
+        doc["shed_requests"] = admission.getShedTotal();
         
         String response;
         serializeJson(doc, response);
@@ -62,12 +108,18 @@ void ESP32APIServer::setupRoutes() {
     
     // API Distance
     server.on("/api/distance", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        float distance = distanceSensor->readDistance();
+        if (!admitRequest(request, AdmissionController::READ)) return;
+        DeadlineScope deadline(readDeadlineId);
+        
+        SystemSnapshot state = systemState->read();
         
         StaticJsonDocument<256> doc;
-        doc["distance"] = distance;
-        doc["detected"] = distanceSensor->isObjectDetected(DETECTION_DISTANCE_CM);
+        doc["distance"] = state.distanceCm;
+        doc["detected"] = state.objectDetected;
         doc["threshold"] = DETECTION_DISTANCE_CM;
+        doc["approach_speed"] = state.approachSpeedCmS;
+        doc["eta_ms"] = state.etaMs;
+        doc["confidence"] = state.approachConfidence;
         
         String response;
         serializeJson(doc, response);
@@ -76,9 +128,15 @@ void ESP32APIServer::setupRoutes() {
     
     // API Gate Status
     server.on("/api/gate", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::READ)) return;
+        DeadlineScope deadline(readDeadlineId);
+        
+        SystemSnapshot state = systemState->read();
+        
         StaticJsonDocument<256> doc;
-        doc["gate"] = servoController->isGateOpen();
-        doc["position"] = servoController->getCurrentAngle();
+        doc["gate"] = state.gateOpen;
+        doc["position"] = state.gateAngle;
+        doc["moving"] = state.gateMoving;
         
         String response;
         serializeJson(doc, response);
@@ -87,6 +145,9 @@ void ESP32APIServer::setupRoutes() {
     
     // API Gate Control
     server.on("/api/gate", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::CONTROL)) return;
+        DeadlineScope deadline(controlDeadlineId);
+        
         if (!request->hasParam("action")) {
             request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Missing action parameter\"}");
             return;
@@ -116,8 +177,11 @@ void ESP32APIServer::setupRoutes() {
     
     // API Photo - Redirige vers ESP32-CAM stream avec CORS
     server.on("/api/photo", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        // Redirection directe vers le stream ESP32-CAM
-        String streamUrl = "http://" + camClient->getIP() + "/stream";
+        if (!admitRequest(request, AdmissionController::READ)) return;
+        DeadlineScope deadline(readDeadlineId);
+        
+        // Redirection directe vers le stream de la caméra principale
+        String streamUrl = "http://" + cameraPool->getCamera(0)->getIP() + "/stream";
         
         AsyncWebServerResponse *response = request->beginResponse(302);
         response->addHeader("Access-Control-Allow-Origin", "*");
@@ -127,6 +191,9 @@ void ESP32APIServer::setupRoutes() {
     
     // API Auto Photo Toggle
     server.on("/api/auto", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::CONTROL)) return;
+        DeadlineScope deadline(controlDeadlineId);
+        
         autoPhotoEnabled = !autoPhotoEnabled;
         
         StaticJsonDocument<256> doc;
@@ -139,17 +206,281 @@ void ESP32APIServer::setupRoutes() {
         request->send(200, "application/json", response);
     });
     
-    // API ESP32-CAM Status
+    // API ESP32-CAM Status - santé agrégée du pool (aucun appel réseau ici)
     server.on("/api/esp32cam", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        String camStatus = camClient->getStatus();
-        request->send(200, "application/json", camStatus);
+        if (!admitRequest(request, AdmissionController::READ)) return;
+        DeadlineScope deadline(readDeadlineId);
+        
+        StaticJsonDocument<1024> doc;
+        doc["cameras"] = cameraPool->getCameraCount();
+        doc["healthy"] = cameraPool->getHealthyCount();
+        doc["circuit"] = CircuitBreaker::stateToString(cameraPool->getWorstCircuit());
+        
+        JsonArray list = doc.createNestedArray("list");
+        for (uint8_t i = 0; i < cameraPool->getCameraCount(); i++) {
+            ESP32CAMClient* cam = cameraPool->getCamera(i);
+            CameraPool::CameraResult capture = cameraPool->getLastCapture(i);
+            CameraPool::CameraResult probe = cameraPool->getLastProbe(i);
+            JsonObject entry = list.createNestedObject();
+            entry["name"] = cameraPool->getCameraName(i);
+            entry["ip"] = cam->getIP();
+            entry["reachable"] = cameraPool->isReachable(i);
+            entry["circuit"] = cam->getCircuitState();
+            entry["last_result"] = ESP32CAMClient::resultToString(cam->getLastResult());
+            entry["last_capture_ok"] = capture.success;
+            entry["last_capture_ms"] = capture.latencyMs;
+            entry["last_probe_ms"] = probe.latencyMs;
+            entry["last_probe_age_ms"] = probe.completedAt ? millis() - probe.completedAt : 0;
+        }
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+    
+    // API Capture - déclenche toutes les caméras en parallèle (réponse immédiate)
+    server.on("/api/capture", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::CONTROL)) return;
+        DeadlineScope deadline(controlDeadlineId);
+        
+        uint32_t roundId = 0;
+        CameraPool::TriggerResult result = cameraPool->triggerCapture(&roundId);
+        if (result == CameraPool::TRIGGER_BUSY) {
+            request->send(409, "application/json", "{\"status\":\"error\",\"message\":\"Capture already running or queued\"}");
+            return;
+        }
+        if (result == CameraPool::TRIGGER_UNAVAILABLE) {
+            request->send(503, "application/json", "{\"status\":\"error\",\"message\":\"Camera pool not running\"}");
+            return;
+        }
+        
+        // Sondage de santé en cours : la capture part dès sa fin (loop())
+        StaticJsonDocument<128> doc;
+        doc["status"] = result == CameraPool::TRIGGER_QUEUED ? "queued" : "accepted";
+        doc["round"] = roundId;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(202, "application/json", response);
     });
     
-    server.onNotFound([](AsyncWebServerRequest *request) {
+    // API Capture - résultats de la dernière ronde
+    server.on("/api/capture", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::READ)) return;
+        DeadlineScope deadline(readDeadlineId);
+        
+        CameraPool::RoundInfo round = cameraPool->getLastRound();
+        StaticJsonDocument<768> doc;
+        doc["round"] = round.id;
+        doc["type"] = round.command == CameraPool::CMD_CAPTURE ? "capture" : "probe";
+        doc["in_progress"] = round.inProgress;
+        doc["queued_ms"] = round.queuedMs;
+        doc["latency_ms"] = round.latencyMs;
+        doc["succeeded"] = round.succeeded;
+        doc["cameras"] = round.cameras;
+        
+        JsonArray list = doc.createNestedArray("results");
+        // Résultats du type de la dernière ronde (capture ou sondage)
+        for (uint8_t i = 0; i < cameraPool->getCameraCount(); i++) {
+            CameraPool::CameraResult result = round.command == CameraPool::CMD_CAPTURE ?
+                cameraPool->getLastCapture(i) : cameraPool->getLastProbe(i);
+            JsonObject entry = list.createNestedObject();
+            entry["name"] = cameraPool->getCameraName(i);
+            entry["success"] = result.success;
+            entry["latency_ms"] = result.latencyMs;
+        }
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+    
+    // API History - séries sous-échantillonnées (LTTB), écrites en flux
+    server.on("/api/history", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::READ)) return;
+        DeadlineScope deadline(readDeadlineId);
+        
+        TimeSeriesHistory::Metric metric = TimeSeriesHistory::METRIC_DISTANCE;
+        if (request->hasParam("metric") &&
+            !TimeSeriesHistory::metricFromName(request->getParam("metric")->value(), metric)) {
+            request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Unknown metric (distance, detected, gate_angle, free_heap, loop_latency)\"}");
+            return;
+        }
+        uint32_t rangeMs = request->hasParam("range") ? request->getParam("range")->value().toInt() : 60000;
+        size_t points = request->hasParam("points") ? request->getParam("points")->value().toInt() : 100;
+        if (rangeMs == 0) rangeMs = 60000;
+        if (points == 0 || points > HISTORY_MAX_POINTS) points = HISTORY_MAX_POINTS;
+        
+        uint32_t now = millis();
+        TimeSeriesHistory::Tier tier = history->selectTier(now, rangeMs);
+        
+        AsyncResponseStream *stream = request->beginResponseStream("application/json");
+        stream->addHeader("Access-Control-Allow-Origin", "*");
+        stream->printf("{\"metric\":\"%s\",\"unit\":\"%s\",\"tier\":\"%s\",\"now\":%u,\"range\":%u,\"points\":[",
+                       TimeSeriesHistory::metricName(metric), TimeSeriesHistory::metricUnit(metric),
+                       TimeSeriesHistory::tierName(tier), now, rangeMs);
+        
+        HistoryStreamContext ctx = { stream, tier == TimeSeriesHistory::TIER_RAW, 0 };
+        history->query(metric, tier, now, rangeMs, points, emitHistoryPoint, &ctx);
+        
+        stream->print("]}");
+        request->send(stream);
+    });
+    
+    // API Admission - compteurs de requêtes rejetées
+    server.on("/api/admission", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::READ)) return;
+        DeadlineScope deadline(readDeadlineId);
+        
+        const AdmissionController::Counters& c = admission.getCounters();
+        StaticJsonDocument<256> doc;
+        doc["in_flight"] = admission.getInFlight();
+        doc["admitted"] = c.admitted;
+        doc["rate_limited"] = c.rateLimited;
+        doc["overloaded"] = c.overloaded;
+        doc["low_memory"] = c.lowMemory;
+        doc["shed_total"] = admission.getShedTotal();
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+    
+    // API Diagnostics - cause du dernier reset, budgets et dépassements persistés
+    server.on("/api/diagnostics", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::READ)) return;
+        DeadlineScope deadline(readDeadlineId);
+        
+        AsyncResponseStream *stream = request->beginResponseStream("application/json");
+        stream->addHeader("Access-Control-Allow-Origin", "*");
+        stream->printf("{\"reset_reason\":\"%s\",\"boot\":%u,\"uptime\":%lu,\"healthy\":%s,\"checkpoints\":%u,\"tasks\":[",
+                       DebugHelper::getResetReasonString(esp_reset_reason()).c_str(),
+                       DeadlineMonitor::getBootCount(), millis(),
+                       DeadlineMonitor::isHealthy() ? "true" : "false",
+                       DeadlineMonitor::getCheckpointCount());
+        
+        for (uint8_t i = 0; i < DeadlineMonitor::getTaskCount(); i++) {
+            const DeadlineMonitor::TaskInfo& task = DeadlineMonitor::getTask(i);
+            stream->printf("%s{\"name\":\"%s\",\"budget\":%u,\"last\":%u,\"max\":%u,\"overruns\":%u,\"active\":%s}",
+                           i ? "," : "", task.name, task.budgetMs, task.lastMs, task.maxMs, task.overruns,
+                           task.active ? "true" : "false");
+        }
+        
+        stream->print("],\"overruns\":[");
+        for (uint8_t i = 0; i < DeadlineMonitor::getPersistedCount(); i++) {
+            OverrunRecord rec = DeadlineMonitor::getPersisted(i);
+            stream->printf("%s{\"name\":\"%s\",\"duration\":%u,\"budget\":%u,\"uptime\":%u,\"boot\":%u,\"ongoing\":%s}",
+                           i ? "," : "", rec.name, rec.durationMs, rec.budgetMs, rec.uptimeMs, rec.boot,
+                           rec.ongoing ? "true" : "false");
+        }
+        stream->print("]}");
+        request->send(stream);
+    });
+    
+    // API Trace - téléchargement binaire (tampon RAM ou fichier flash)
+    server.on("/api/trace", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::READ)) return;
+        DeadlineScope deadline(readDeadlineId);
+        
+        // Enregistrement et vidage flash suspendus le temps du transfert
+        // pour garder un tampon et un fichier cohérents
+        TraceRecorder::pause();
+        onRequestEnd(request, []() { TraceRecorder::resume(); });
+        
+        if (request->hasParam("source") && request->getParam("source")->value() == "flash") {
+            // Le fichier est lu par morceaux dans la tâche AsyncTCP ; les écritures
+            // (vidage, troncature) restent dans loop() et attendent la fin du transfert
+            if (!LittleFS.exists(TRACE_FILE_PATH)) {
+                request->send(404, "application/json", "{\"status\":\"error\",\"message\":\"No trace file\"}");
+                return;
+            }
+            request->send(LittleFS, TRACE_FILE_PATH, "application/octet-stream", true);
+            return;
+        }
+        
+        AsyncWebServerResponse *resp = request->beginResponse("application/octet-stream",
+            TraceRecorder::getSerializedSize(),
+            [](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                return TraceRecorder::serialize(buffer, index, maxLen);
+            });
+        resp->addHeader("Content-Disposition", "attachment; filename=trace.bin");
+        request->send(resp);
+    });
+    
+    // API Trace - contrôle de l'enregistrement
+    server.on("/api/trace", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::CONTROL)) return;
+        DeadlineScope deadline(controlDeadlineId);
+        
+        String action = request->hasParam("action") ? request->getParam("action")->value() : "";
+        if (action == "start") {
+            bool toFlash = request->hasParam("flash") && request->getParam("flash")->value() == "1";
+            TraceRecorder::start(toFlash);
+        } else if (action == "stop") {
+            TraceRecorder::stop();
+        } else if (action == "clear") {
+            TraceRecorder::clear();
+        } else if (action != "") {
+            request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid action (use: start/stop/clear)\"}");
+            return;
+        }
+        
+        StaticJsonDocument<256> doc;
+        doc["status"] = "success";
+        doc["recording"] = TraceRecorder::isRecording();
+        doc["pending"] = TraceRecorder::hasPendingCommand();
+        doc["buffered"] = TraceRecorder::getBufferedCount();
+        doc["total"] = TraceRecorder::getTotalRecords();
+        doc["dropped"] = TraceRecorder::getDroppedRecords();
+        doc["flash_bytes"] = TraceRecorder::getFlashBytes();
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+    
+    // Les 404 passent aussi par l'admission : un scanner d'URL est limité comme une lecture
+    server.onNotFound([this](AsyncWebServerRequest *request) {
+        if (!admitRequest(request, AdmissionController::READ)) return;
         request->send(404, "application/json", "{\"status\":\"error\",\"message\":\"Endpoint not found\"}");
     });
 }
 
+bool ESP32APIServer::admitRequest(AsyncWebServerRequest *request, AdmissionController::RequestClass cls) {
+    TraceRecorder::recordApiCall(TraceRecorder::routeFromUrl(request->url().c_str(),
+                                                             request->method() == HTTP_POST));
+    
+    uint32_t clientIP = request->client() ? (uint32_t)request->client()->remoteIP() : 0;
+    AdmissionController::Decision decision = admission.admit(clientIP, cls, ESP.getFreeHeap());
+    
+    if (decision == AdmissionController::ADMITTED) {
+        // La place est libérée quand la connexion se ferme (réponse envoyée)
+        request->onDisconnect([this]() { admission.release(); });
+        return true;
+    }
+    
+    // Réponses de rejet minimales : corps constant, aucun JSON construit
+    if (decision == AdmissionController::RATE_LIMITED) {
+        AsyncWebServerResponse *resp = request->beginResponse(429, "application/json",
+            "{\"status\":\"error\",\"message\":\"Too many requests\"}");
+        resp->addHeader("Retry-After", "1");
+        request->send(resp);
+    } else {
+        request->send(503, "application/json",
+            "{\"status\":\"error\",\"message\":\"Server busy\"}");
+    }
+    return false;
+}
+
+void ESP32APIServer::onRequestEnd(AsyncWebServerRequest *request, std::function<void()> action) {
+    // ESPAsyncWebServer ne garde qu'un callback de déconnexion : il remplace
+    // celui d'admitRequest, la place d'admission doit donc être libérée ici aussi
+    request->onDisconnect([this, action]() {
+        action();
+        admission.release();
+    });
+}
+
 String ESP32APIServer::generateWebInterface() {
     // Interface ultra-minimaliste pour économiser la mémoire
     String html = "<html><head><title>SmartGate</title></head><body>";
@@ -158,8 +489,11 @@ String ESP32APIServer::generateWebInterface() {
     html += "<button onclick=\"fetch('/api/gate?action=open',{method:'POST'})\">OPEN</button> ";
     html += "<button onclick=\"fetch('/api/gate?action=close',{method:'POST'})\">CLOSE</button> ";
     html += "<button onclick=\"window.open('/api/photo','_blank')\">PHOTO</button> ";
-    html += "<button onclick=\"r()\">REFRESH</button>";
-    html += "<script>function r(){fetch('/api/status').then(a=>a.json()).then(d=>{document.getElementById('d').innerHTML=d.distance.toFixed(1);document.getElementById('g').innerHTML=d.gate?'OPEN':'CLOSED'})}</script>";
+    html += "<button onclick=\"r()\">REFRESH</button> ";
+    html += "<button onclick=\"h()\">HISTORY</button>";
+    html += "<p><svg id='c' width='400' height='100'><polyline id='l' fill='none' stroke='black'/></svg></p>";
+    html += "<script>function r(){fetch('/api/status').then(a=>a.json()).then(d=>{document.getElementById('d').innerHTML=d.distance.toFixed(1);document.getElementById('g').innerHTML=d.gate?'OPEN':'CLOSED'})}";
+    html += "function h(){fetch('/api/history?metric=distance&range=600000&points=100').then(a=>a.json()).then(d=>{var p=d.points;if(!p.length)return;var t0=p[0][0],t1=p[p.length-1][0];document.getElementById('l').setAttribute('points',p.map(q=>(400*(q[0]-t0)/Math.max(t1-t0,1))+','+(100-Math.min(q[1],400)/4)).join(' '))})}</script>";
     html += "</body></html>";
     return html;
 }
@@ -176,7 +510,14 @@ void ESP32APIServer::begin() {
     Serial.println("  POST /api/gate      - Gate control");
     Serial.println("  GET  /api/photo     - Photo stream (redirects to ESP32-CAM)");
     Serial.println("  POST /api/auto      - Toggle auto photo");
-    Serial.println("  GET  /api/esp32cam  - ESP32-CAM status");
+    Serial.println("  GET  /api/esp32cam  - Camera pool health");
+    Serial.println("  POST /api/capture   - Trigger capture on all cameras");
+    Serial.println("  GET  /api/capture   - Last capture round results");
+    Serial.println("  GET  /api/admission - Admission control counters");
+    Serial.println("  GET  /api/diagnostics - Reset reason, deadlines and overruns");
+    Serial.println("  GET  /api/history   - Metric history (?metric=&range=&points=)");
+    Serial.println("  GET  /api/trace     - Download trace (?source=flash)");
+    Serial.println("  POST /api/trace     - Trace control (action=start|stop|clear, flash=1)");
 }
 
 String ESP32APIServer::getIPAddress() {
@@ -191,11 +532,14 @@ void ESP32APIServer::setAutoPhoto(bool enabled) {
     autoPhotoEnabled = enabled;
 }
 
+const AdmissionController& ESP32APIServer::getAdmission() const {
+    return admission;
+}
+
 void ESP32APIServer::handleAutoPhoto() {
-    // Auto photo detection disabled to prevent request failures
-    // Uncomment to re-enable automatic photo capture
-    /*
-    if (!autoPhotoEnabled || !distanceSensor || !camClient) {
+    // Appelé depuis loop() : le pool capture en tâche de fond, la boucle
+    // de contrôle n'attend jamais les caméras
+    if (!autoPhotoEnabled || !distanceSensor || !cameraPool) {
         return;
     }
     
@@ -204,15 +548,16 @@ void ESP32APIServer::handleAutoPhoto() {
     if (distanceSensor->isObjectDetected(DETECTION_DISTANCE_CM) && 
         currentTime - lastAutoPhoto >= AUTO_PHOTO_INTERVAL_MS) {
         
-        Serial.println("Object detected! Requesting auto photo...");
-        
-        if (camClient->requestPhoto()) {
-            Serial.println("Auto photo requested successfully");
+        CameraPool::TriggerResult result = cameraPool->triggerCapture();
+        if (result == CameraPool::TRIGGER_STARTED) {
+            Serial.println("Object detected! Auto capture triggered on all cameras");
+        } else if (result == CameraPool::TRIGGER_QUEUED) {
+            Serial.println("Object detected! Auto capture queued behind camera probe");
         } else {
-            Serial.println("Auto photo request failed");
+            // Pas de capture : nouvelle tentative à l'itération suivante
+            return;
         }
         
         lastAutoPhoto = currentTime;
     }
-    */
 }
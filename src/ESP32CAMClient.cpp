@@ -1,8 +1,11 @@
 #include "ESP32CAMClient.h"
+#include "ESP32Config.h"
 #include "DebugHelper.h"
 
 ESP32CAMClient::ESP32CAMClient(const String& ip) 
-    : esp32camIP(ip), lastPhotoRequest(0) {
+    : esp32camIP(ip), lastPhotoRequest(0),
+      breaker(CAM_BREAKER_FAILURE_THRESHOLD, CAM_BREAKER_OPEN_MS, CAM_BREAKER_HALF_OPEN_PROBES),
+      lastResult(CALL_NONE) {
 }
 
 bool ESP32CAMClient::init() {
@@ -10,7 +13,59 @@ bool ESP32CAMClient::init() {
     return true;
 }
 
-bool ESP32CAMClient::requestPhoto() {
+unsigned long ESP32CAMClient::deadlineIn(unsigned long budgetMs) {
+    return millis() + budgetMs;
+}
+
+bool ESP32CAMClient::deadlinePassed(unsigned long deadline) {
+    // Comparaison signée pour rester correcte au débordement de millis()
+    return (long)(deadline - millis()) <= 0;
+}
+
+bool ESP32CAMClient::beginCall(const char* path, unsigned long deadline, const char* operation) {
+    long remaining = (long)(deadline - millis());
+    if (remaining < CAM_MIN_CALL_BUDGET_MS) {
+        Serial.printf("⏱️  %s skipped: deadline budget exhausted (%ld ms)\n", operation, remaining);
+        lastResult = CALL_DEADLINE_EXCEEDED;
+        return false;
+    }
+    
+    // Circuit ouvert : échec immédiat au lieu de payer le timeout complet
+    if (!breaker.allowRequest()) {
+        lastResult = CALL_CIRCUIT_OPEN;
+        return false;
+    }
+    
+    // HTTPClient applique les deux timeouts l'un après l'autre (connexion puis
+    // attente de la réponse) : le budget est partagé pour que leur somme reste
+    // dans l'échéance absolue
+    long connectBudget = remaining * CAM_CONNECT_BUDGET_PCT / 100;
+    httpClient.begin("http://" + esp32camIP + path);
+    httpClient.setConnectTimeout(connectBudget);
+    httpClient.setTimeout(remaining - connectBudget);
+    return true;
+}
+
+void ESP32CAMClient::endCall(int httpResponseCode) {
+    httpClient.end();
+    
+    // Seules les erreurs de transport et les 5xx indiquent une caméra en panne
+    if (httpResponseCode < 0 || httpResponseCode >= 500) {
+        breaker.recordFailure();
+    } else {
+        breaker.recordSuccess();
+    }
+    
+    if (httpResponseCode < 0) {
+        lastResult = CALL_TRANSPORT_ERROR;
+    } else if (httpResponseCode != 200) {
+        lastResult = CALL_HTTP_ERROR;
+    } else {
+        lastResult = CALL_OK;
+    }
+}
+
+bool ESP32CAMClient::requestPhoto(unsigned long deadline) {
     DebugHelper::logCriticalOperation("ESP32CAM Photo Request START");
     unsigned long currentTime = millis();
     
@@ -20,65 +75,67 @@ bool ESP32CAMClient::requestPhoto() {
         return false;
     }
     
-    DebugHelper::feedWatchdog();
+    if (deadline == 0) {
+        deadline = deadlineIn(CAM_PHOTO_TIMEOUT_MS);
+    }
+    
+    if (!beginCall("/capture", deadline, "Photo request")) {
+        Serial.printf("⛔ Photo request fast-failed (circuit %s)\n", breaker.getStateString());
+        return false;
+    }
     
     Serial.printf("📸 Requesting photo from %s...\n", esp32camIP.c_str());
-    httpClient.begin("http://" + esp32camIP + "/capture");
     httpClient.addHeader("Content-Type", "application/json");
-    httpClient.setTimeout(3000); // Réduire timeout à 3 secondes
-    
-    DebugHelper::feedWatchdog();
     
     int httpResponseCode = httpClient.POST("");
     lastPhotoRequest = currentTime;
     
-    DebugHelper::feedWatchdog();
+    // Réponse arrivée hors délai : ne pas lire le corps (chaque lecture a son propre timeout)
+    if (httpResponseCode == 200 && deadlinePassed(deadline)) {
+        endCall(httpResponseCode);
+        lastResult = CALL_DEADLINE_EXCEEDED;
+        Serial.println("⏱️  Photo answered after deadline, body skipped");
+        return false;
+    }
     
     if (httpResponseCode == 200) {
         String response = httpClient.getString();
         Serial.println("✅ Photo OK");
-        httpClient.end();
+        endCall(httpResponseCode);
         DebugHelper::logCriticalOperation("ESP32CAM Photo Request SUCCESS");
         return true;
     } else {
         Serial.printf("❌ Photo failed: HTTP %d\n", httpResponseCode);
-        httpClient.end();
+        endCall(httpResponseCode);
         DebugHelper::logCriticalOperation("ESP32CAM Photo Request FAILED");
         return false;
     }
 }
 
-String ESP32CAMClient::getStatus() {
-    httpClient.begin("http://" + esp32camIP + "/status");
-    httpClient.setTimeout(2000); // Réduire timeout à 2 secondes
-    
-    int httpResponseCode = httpClient.GET();
+bool ESP32CAMClient::isReachable(unsigned long deadline) {
+    if (deadline == 0) {
+        deadline = deadlineIn(CAM_REACHABLE_TIMEOUT_MS);
+    }
     
-    if (httpResponseCode == 200) {
-        String response = httpClient.getString();
-        httpClient.end();
-        yield(); // Donner du temps au watchdog
-        return response;
-    } else {
-        httpClient.end();
-        yield(); // Donner du temps au watchdog
-        return "{\"error\":\"CAM offline\"}";
+    if (!beginCall("/status", deadline, "Reachability check")) {
+        return false;
     }
-}
-
-bool ESP32CAMClient::isReachable() {
-    httpClient.begin("http://" + esp32camIP + "/status");
-    httpClient.setTimeout(1500); // Timeout très court
     
     int httpResponseCode = httpClient.GET();
-    httpClient.end();
+    endCall(httpResponseCode);
     yield(); // Donner du temps au watchdog
     
+    if (httpResponseCode == 200 && deadlinePassed(deadline)) {
+        lastResult = CALL_DEADLINE_EXCEEDED;
+        return false;
+    }
     return (httpResponseCode == 200);
 }
 
 void ESP32CAMClient::setIP(const String& ip) {
     esp32camIP = ip;
+    // Nouvelle caméra : l'historique d'échecs de l'ancienne ne s'applique plus
+    breaker.reset();
     Serial.printf("ESP32-CAM IP updated to: %s\n", ip.c_str());
 }
 
@@ -86,6 +143,30 @@ String ESP32CAMClient::getIP() const {
     return esp32camIP;
 }
 
+CircuitBreaker& ESP32CAMClient::getBreaker() {
+    return breaker;
+}
+
+const char* ESP32CAMClient::getCircuitState() {
+    return breaker.getStateString();
+}
+
+ESP32CAMClient::CallResult ESP32CAMClient::getLastResult() const {
+    return lastResult;
+}
+
+const char* ESP32CAMClient::resultToString(CallResult result) {
+    switch (result) {
+        case CALL_NONE: return "NONE";
+        case CALL_OK: return "OK";
+        case CALL_DEADLINE_EXCEEDED: return "DEADLINE_EXCEEDED";
+        case CALL_CIRCUIT_OPEN: return "CIRCUIT_OPEN";
+        case CALL_HTTP_ERROR: return "HTTP_ERROR";
+        case CALL_TRANSPORT_ERROR: return "TRANSPORT_ERROR";
+        default: return "UNKNOWN";
+    }
+}
+
 String ESP32CAMClient::requestPhotoData() {
     // FONCTION DÉSACTIVÉE - Cause des crashes mémoire
     // Les images de 50KB+ font crash l'ESP32 principal
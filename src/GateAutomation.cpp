@@ -0,0 +1,92 @@
+#include "GateAutomation.h"
+
+GateAutomation::GateAutomation(DistanceSensor& sensor, ServoController& servo, bool enabled,
+                               float thresholdCm, unsigned long closeAfterClearMs,
+                               unsigned long openTimeoutMs)
+    : sensor(sensor), servo(servo), enabled(enabled), thresholdCm(thresholdCm),
+      closeAfterClearMs(closeAfterClearMs), openTimeoutMs(openTimeoutMs),
+      openRequested(false), requestedAt(0), active(false), heldClosed(false), vehicleSeen(false), openedAt(0),
+      lastPresence(0) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void GateAutomation::requestOpen() {
+    stats.requests++;
+    if (enabled && !openRequested) {
+        requestedAt = millis();
+        openRequested = true;
+    }
+}
+
+bool GateAutomation::vehiclePresent(unsigned long now) {
+    if (!sensor.isObjectDetected(thresholdCm)) {
+        return false;
+    }
+    // Distance sous le seuil mais plus d'écho valide depuis : timeouts et
+    // hors plage comptent comme "dégagé", la présence date du dernier écho
+    unsigned long lastValid = sensor.getLastValidReadTime();
+    if (lastValid > lastPresence) {
+        lastPresence = lastValid;
+    }
+    return lastValid >= now || now - lastValid < closeAfterClearMs;
+}
+
+void GateAutomation::update(unsigned long now) {
+    if (heldClosed && !vehiclePresent(now)) {
+        heldClosed = false;
+    }
+    
+    if (openRequested) {
+        openRequested = false;
+        // L'opérateur a refermé sur ce véhicule : pas de réouverture avant qu'il soit parti
+        if (heldClosed) {
+            return;
+        }
+        // openGate() passe par le mutex du servo : sérialisé avec les commandes API
+        if (!servo.isGateOpen() && servo.openGate(true)) {
+            active = true;
+            vehicleSeen = false;
+            openedAt = millis();
+            stats.opens++;
+            stats.lastOpenDelayMs = openedAt - requestedAt;
+        }
+        return;
+    }
+    
+    if (!active) {
+        return;
+    }
+    // Fermée entre-temps (API) : plus rien à superviser
+    if (!servo.isGateOpen()) {
+        active = false;
+        heldClosed = vehiclePresent(now);
+        return;
+    }
+    
+    if (vehiclePresent(now)) {
+        vehicleSeen = true;
+        return;
+    }
+    
+    bool passed = vehicleSeen && now > lastPresence && now - lastPresence >= closeAfterClearMs;
+    bool noShow = !vehicleSeen && now - openedAt >= openTimeoutMs;
+    if (passed || noShow) {
+        Serial.println(passed ? "🚗 Vehicle passed, closing gate" : "⚠️  Announced vehicle never arrived, closing gate");
+        if (servo.closeGate(true)) {
+            active = false;
+            if (passed) {
+                stats.closedPassed++;
+            } else {
+                stats.closedNoShow++;
+            }
+        }
+    }
+}
+
+bool GateAutomation::isActive() const {
+    return active;
+}
+
+const GateAutomation::Stats& GateAutomation::getStats() const {
+    return stats;
+}
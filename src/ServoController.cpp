@@ -1,7 +1,11 @@
 #include "ServoController.h"
+#include "ESP32Config.h"
+#include "TraceRecorder.h"
+#include "DeadlineMonitor.h"
 
 ServoController::ServoController(int pin, int openPos, int closedPos) 
-    : servoPin(pin), isOpen(false), openAngle(openPos), closedAngle(closedPos) {
+    : servoPin(pin), isOpen(false), moving(false), openAngle(openPos), closedAngle(closedPos),
+      deadlineId(-1), moveLock(nullptr) {
 }
 
 bool ServoController::init() {
@@ -18,24 +22,52 @@ bool ServoController::init() {
     isOpen = false;
     delay(500);
     
+    moveLock = xSemaphoreCreateMutex();
+    if (moveLock == nullptr) {
+        Serial.println("❌ Servo: mutex allocation failed");
+        return false;
+    }
+    deadlineId = DeadlineMonitor::registerTask("servo", DEADLINE_SERVO_MS);
+    
     Serial.printf("Servo controller initialized on pin %d (closed position: %d°)\n", 
                   servoPin, closedAngle);
     return true;
 }
 
-bool ServoController::openGate() {
-    servo.write(openAngle);
-    isOpen = true;
-    delay(500); // Laisser le temps au servo de bouger
+bool ServoController::moveTo(int angle, bool open, bool automatic) {
+    if (moveLock == nullptr || xSemaphoreTake(moveLock, pdMS_TO_TICKS(SERVO_MOVE_WAIT_MS)) != pdTRUE) {
+        Serial.println("⚠️  Servo busy, move skipped");
+        return false;
+    }
+    
+    {
+        // Un seul mouvement à la fois : le créneau "servo" n'a qu'un utilisateur
+        DeadlineScope deadline(deadlineId);
+        moving = true;
+        servo.write(angle);
+        isOpen = open;
+        TraceRecorder::recordGate(angle, open, automatic);
+        delay(500); // Laisser le temps au servo de bouger
+        moving = false;
+    }
+    
+    xSemaphoreGive(moveLock);
+    return true;
+}
+
+bool ServoController::openGate(bool automatic) {
+    if (!moveTo(openAngle, true, automatic)) {
+        return false;
+    }
     
     Serial.printf("Gate OPENED (servo: %d°)\n", openAngle);
     return true;
 }
 
-bool ServoController::closeGate() {
-    servo.write(closedAngle);
-    isOpen = false;
-    delay(500); // Laisser le temps au servo de bouger
+bool ServoController::closeGate(bool automatic) {
+    if (!moveTo(closedAngle, false, automatic)) {
+        return false;
+    }
     
     Serial.printf("Gate CLOSED (servo: %d°)\n", closedAngle);
     return true;
@@ -47,9 +79,9 @@ bool ServoController::setPosition(int angle) {
         return false;
     }
     
-    servo.write(angle);
-    isOpen = (angle > (closedAngle + openAngle) / 2);
-    delay(500);
+    if (!moveTo(angle, angle > (closedAngle + openAngle) / 2)) {
+        return false;
+    }
     
     Serial.printf("Servo position set to %d°\n", angle);
     return true;
@@ -62,3 +94,7 @@ bool ServoController::isGateOpen() const {
 int ServoController::getCurrentAngle() const {
     return isOpen ? openAngle : closedAngle;
 }
+
+bool ServoController::isMoving() const {
+    return moving;
+}
@@ -0,0 +1,58 @@
+#include "SystemState.h"
+
+#include <string.h>
+
+SystemState::SystemState() : sequence(0) {
+    for (size_t i = 0; i < WORDS; i++) {
+        words[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void SystemState::publish(const SystemSnapshot& snapshot) {
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    
+    SystemSnapshot stamped = snapshot;
+    stamped.version = (seq + 2) / 2;
+    uint32_t buffer[WORDS] = {};
+    memcpy(buffer, &stamped, sizeof(stamped));
+    
+    // Séquence impaire : écriture en cours
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    for (size_t i = 0; i < WORDS; i++) {
+        words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+    
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+SystemSnapshot SystemState::read(uint32_t* retries) const {
+    uint32_t buffer[WORDS];
+    uint32_t before;
+    uint32_t after;
+    
+    do {
+        before = sequence.load(std::memory_order_acquire);
+        for (size_t i = 0; i < WORDS; i++) {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = sequence.load(std::memory_order_relaxed);
+        
+        if ((before & 1) == 0 && before == after) {
+            break;
+        }
+        if (retries) {
+            (*retries)++;
+        }
+    } while (true);
+    
+    SystemSnapshot copy;
+    memcpy(&copy, buffer, sizeof(copy));
+    return copy;
+}
+
+uint32_t SystemState::getVersion() const {
+    return sequence.load(std::memory_order_acquire) / 2;
+}
@@ -0,0 +1,297 @@
+#include "TimeSeriesHistory.h"
+
+TimeSeriesHistory::TimeSeriesHistory()
+    : rawHead(0), rawCount(0), head1s(0), count1s(0), head10s(0), count10s(0) {
+    memset(&acc1s, 0, sizeof(acc1s));
+    memset(&acc10s, 0, sizeof(acc10s));
+    lock = portMUX_INITIALIZER_UNLOCKED;
+}
+
+uint16_t TimeSeriesHistory::encode(Metric metric, float value) {
+    float scaled;
+    switch (metric) {
+        case METRIC_DISTANCE: scaled = value * 10.0f; break;
+        case METRIC_DETECTED: scaled = value > 0 ? 1000.0f : 0.0f; break;
+        case METRIC_FREE_HEAP: scaled = value / 16.0f; break;
+        default: scaled = value; break;
+    }
+    if (scaled < 0) return 0;
+    if (scaled > 65535.0f) return 65535;
+    return (uint16_t)(scaled + 0.5f);
+}
+
+float TimeSeriesHistory::decode(Metric metric, uint16_t raw) {
+    switch (metric) {
+        case METRIC_DISTANCE: return raw / 10.0f;
+        case METRIC_DETECTED: return raw / 1000.0f;
+        case METRIC_FREE_HEAP: return raw * 16.0f;
+        default: return raw;
+    }
+}
+
+void TimeSeriesHistory::accumulate(Accumulator& acc, uint32_t startMs, const uint16_t* values, uint16_t weight) {
+    if (acc.count == 0) {
+        acc.startMs = startMs;
+        for (uint8_t m = 0; m < METRIC_COUNT; m++) {
+            acc.min[m] = values[m];
+            acc.max[m] = values[m];
+            acc.sum[m] = 0;
+        }
+    }
+    for (uint8_t m = 0; m < METRIC_COUNT; m++) {
+        if (values[m] < acc.min[m]) acc.min[m] = values[m];
+        if (values[m] > acc.max[m]) acc.max[m] = values[m];
+        acc.sum[m] += (uint32_t)values[m] * weight;
+    }
+    acc.count += weight;
+}
+
+void TimeSeriesHistory::closeBucket(const Accumulator& acc, Bucket& out) {
+    out.startMs = acc.startMs;
+    for (uint8_t m = 0; m < METRIC_COUNT; m++) {
+        out.min[m] = acc.min[m];
+        out.max[m] = acc.max[m];
+        out.avg[m] = acc.sum[m] / acc.count;
+    }
+}
+
+void TimeSeriesHistory::add(uint32_t nowMs, float distanceCm, bool detected, int gateAngle,
+                            uint32_t freeHeap, uint32_t loopLatencyMs) {
+    uint16_t values[METRIC_COUNT];
+    values[METRIC_DISTANCE] = encode(METRIC_DISTANCE, distanceCm);
+    values[METRIC_DETECTED] = encode(METRIC_DETECTED, detected ? 1.0f : 0.0f);
+    values[METRIC_GATE_ANGLE] = encode(METRIC_GATE_ANGLE, gateAngle);
+    values[METRIC_FREE_HEAP] = encode(METRIC_FREE_HEAP, freeHeap);
+    values[METRIC_LOOP_LATENCY] = encode(METRIC_LOOP_LATENCY, loopLatencyMs);
+    
+    portENTER_CRITICAL(&lock);
+    
+    RawSample& sample = raw[rawHead];
+    sample.timestampMs = nowMs;
+    memcpy(sample.values, values, sizeof(values));
+    rawHead = (rawHead + 1) % HISTORY_RAW_POINTS;
+    if (rawCount < HISTORY_RAW_POINTS) rawCount++;
+    
+    // Changement de seconde : le seau 1 s est clos et replié dans le seau 10 s
+    uint32_t second = nowMs / 1000;
+    if (acc1s.count > 0 && acc1s.startMs / 1000 != second) {
+        closeBucket(acc1s, buckets1s[head1s]);
+        head1s = (head1s + 1) % HISTORY_1S_POINTS;
+        if (count1s < HISTORY_1S_POINTS) count1s++;
+        
+        uint32_t tenSeconds = (acc1s.startMs / 1000) / 10;
+        if (acc10s.count > 0 && (acc10s.startMs / 1000) / 10 != tenSeconds) {
+            closeBucket(acc10s, buckets10s[head10s]);
+            head10s = (head10s + 1) % HISTORY_10S_POINTS;
+            if (count10s < HISTORY_10S_POINTS) count10s++;
+            acc10s.count = 0;
+        }
+        // Le seau 10 s garde min/max réels et une moyenne pondérée par échantillon
+        uint16_t avg[METRIC_COUNT];
+        for (uint8_t m = 0; m < METRIC_COUNT; m++) {
+            avg[m] = acc1s.sum[m] / acc1s.count;
+        }
+        bool first10s = acc10s.count == 0;
+        accumulate(acc10s, acc1s.startMs, avg, acc1s.count);
+        for (uint8_t m = 0; m < METRIC_COUNT; m++) {
+            if (first10s || acc1s.min[m] < acc10s.min[m]) acc10s.min[m] = acc1s.min[m];
+            if (first10s || acc1s.max[m] > acc10s.max[m]) acc10s.max[m] = acc1s.max[m];
+        }
+        acc1s.count = 0;
+    }
+    accumulate(acc1s, nowMs, values, 1);
+    
+    portEXIT_CRITICAL(&lock);
+}
+
+// Éléments les plus anciens d'un anneau plein ignorés par query() : loop()
+// peut les écraser pendant la requête. La requête tourne dans la tâche AsyncTCP
+// sans appel bloquant (le flux est écrit en mémoire) et dure quelques ms,
+// tandis que loop() n'ajoute qu'un échantillon brut par itération (>= 200 ms)
+// et un seau par seconde : 4 éléments laissent plus de 800 ms de marge.
+#define HISTORY_READ_MARGIN 4
+
+TimeSeriesHistory::Tier TimeSeriesHistory::selectTier(uint32_t nowMs, uint32_t rangeMs) const {
+    const Tier tiers[] = { TIER_RAW, TIER_1S };
+    for (Tier tier : tiers) {
+        uint16_t head, count;
+        tierState(tier, head, count);
+        uint16_t capacity = tierCapacity(tier);
+        
+        // Anneau pas encore plein : rien n'a été écrasé depuis le démarrage
+        if (count < capacity) return tier;
+        
+        HistoryPoint oldest;
+        pointAt(tier, head, HISTORY_READ_MARGIN, METRIC_DISTANCE, oldest);
+        if (nowMs - oldest.timestampMs >= rangeMs) return tier;
+    }
+    return TIER_10S;
+}
+
+void TimeSeriesHistory::tierState(Tier tier, uint16_t& head, uint16_t& count) const {
+    portENTER_CRITICAL(&lock);
+    head = (tier == TIER_RAW) ? rawHead : (tier == TIER_1S) ? head1s : head10s;
+    count = (tier == TIER_RAW) ? rawCount : (tier == TIER_1S) ? count1s : count10s;
+    portEXIT_CRITICAL(&lock);
+}
+
+uint16_t TimeSeriesHistory::tierCapacity(Tier tier) const {
+    switch (tier) {
+        case TIER_RAW: return HISTORY_RAW_POINTS;
+        case TIER_1S: return HISTORY_1S_POINTS;
+        default: return HISTORY_10S_POINTS;
+    }
+}
+
+void TimeSeriesHistory::pointAt(Tier tier, uint16_t oldest, uint16_t index, Metric metric,
+                                HistoryPoint& out) const {
+    uint16_t slot = (oldest + index) % tierCapacity(tier);
+    
+    // Verrou de l'écrivain par point : loop() (cœur 1) ne peut pas déchirer
+    // un échantillon pendant sa lecture depuis AsyncTCP (cœur 0)
+    if (tier == TIER_RAW) {
+        portENTER_CRITICAL(&lock);
+        RawSample s = raw[slot];
+        portEXIT_CRITICAL(&lock);
+        out.timestampMs = s.timestampMs;
+        out.value = decode(metric, s.values[metric]);
+        out.min = out.value;
+        out.max = out.value;
+        return;
+    }
+    
+    portENTER_CRITICAL(&lock);
+    Bucket b = (tier == TIER_1S) ? buckets1s[slot] : buckets10s[slot];
+    portEXIT_CRITICAL(&lock);
+    out.timestampMs = b.startMs;
+    out.value = decode(metric, b.avg[metric]);
+    out.min = decode(metric, b.min[metric]);
+    out.max = decode(metric, b.max[metric]);
+}
+
+size_t TimeSeriesHistory::query(Metric metric, Tier tier, uint32_t nowMs, uint32_t rangeMs, size_t maxPoints,
+                                HistoryEmitCallback emit, void* context) const {
+    uint16_t capacity = tierCapacity(tier);
+    uint16_t head, count;
+    tierState(tier, head, count);
+    
+    // Les points sont lus un par un sous verrou (voir pointAt) ; seuls les
+    // plus anciens peuvent être écrasés entre deux lectures, on les saute
+    uint16_t oldest = (head + capacity - count) % capacity;
+    size_t first = (count == capacity) ? HISTORY_READ_MARGIN : 0;
+    
+    HistoryPoint p;
+    while (first < count) {
+        pointAt(tier, oldest, first, metric, p);
+        if (nowMs - p.timestampMs <= rangeMs) break;
+        first++;
+    }
+    if (first >= count || maxPoints == 0) {
+        return 0;
+    }
+    size_t n = count - first;
+    
+    if (maxPoints >= n || maxPoints < 3) {
+        size_t limit = min(n, maxPoints);
+        for (size_t i = 0; i < limit; i++) {
+            pointAt(tier, oldest, first + i, metric, p);
+            emit(p, context);
+        }
+        return limit;
+    }
+    
+    // Largest-Triangle-Three-Buckets : garde la forme de la courbe (pics
+    // compris) en maxPoints points ; premier et dernier points conservés
+    HistoryPoint a;
+    pointAt(tier, oldest, first, metric, a);
+    emit(a, context);
+    
+    float bucketSize = (float)(n - 2) / (maxPoints - 2);
+    for (size_t b = 0; b < maxPoints - 2; b++) {
+        size_t start = 1 + (size_t)(b * bucketSize);
+        size_t end = 1 + (size_t)((b + 1) * bucketSize);
+        size_t nextEnd = min((size_t)(1 + (size_t)((b + 2) * bucketSize)), n);
+        
+        // Moyenne du seau suivant (dernier point pour le dernier seau)
+        float avgT = 0;
+        float avgV = 0;
+        size_t nextCount = 0;
+        for (size_t i = end; i < nextEnd; i++) {
+            pointAt(tier, oldest, first + i, metric, p);
+            avgT += (float)(p.timestampMs - a.timestampMs);
+            avgV += p.value;
+            nextCount++;
+        }
+        if (nextCount == 0) {
+            pointAt(tier, oldest, first + n - 1, metric, p);
+            avgT = (float)(p.timestampMs - a.timestampMs);
+            avgV = p.value;
+        } else {
+            avgT /= nextCount;
+            avgV /= nextCount;
+        }
+        
+        // Point du seau courant formant le plus grand triangle avec a et la moyenne suivante
+        float bestArea = -1;
+        HistoryPoint best = a;
+        for (size_t i = start; i < end; i++) {
+            pointAt(tier, oldest, first + i, metric, p);
+            float dt = (float)(p.timestampMs - a.timestampMs);
+            float area = fabsf(dt * (avgV - a.value) - avgT * (p.value - a.value));
+            if (area > bestArea) {
+                bestArea = area;
+                best = p;
+            }
+        }
+        emit(best, context);
+        a = best;
+    }
+    
+    pointAt(tier, oldest, first + n - 1, metric, p);
+    emit(p, context);
+    return maxPoints;
+}
+
+bool TimeSeriesHistory::metricFromName(const String& name, Metric& out) {
+    for (uint8_t m = 0; m < METRIC_COUNT; m++) {
+        if (name == metricName((Metric)m)) {
+            out = (Metric)m;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* TimeSeriesHistory::metricName(Metric metric) {
+    switch (metric) {
+        case METRIC_DISTANCE: return "distance";
+        case METRIC_DETECTED: return "detected";
+        case METRIC_GATE_ANGLE: return "gate_angle";
+        case METRIC_FREE_HEAP: return "free_heap";
+        case METRIC_LOOP_LATENCY: return "loop_latency";
+        default: return "unknown";
+    }
+}
+
+const char* TimeSeriesHistory::metricUnit(Metric metric) {
+    switch (metric) {
+        case METRIC_DISTANCE: return "cm";
+        case METRIC_DETECTED: return "ratio";
+        case METRIC_GATE_ANGLE: return "deg";
+        case METRIC_FREE_HEAP: return "bytes";
+        case METRIC_LOOP_LATENCY: return "ms";
+        default: return "";
+    }
+}
+
+const char* TimeSeriesHistory::tierName(Tier tier) {
+    switch (tier) {
+        case TIER_RAW: return "raw";
+        case TIER_1S: return "1s";
+        default: return "10s";
+    }
+}
+
+size_t TimeSeriesHistory::getMemoryBytes() {
+    return sizeof(TimeSeriesHistory);
+}
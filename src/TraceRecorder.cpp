@@ -0,0 +1,322 @@
+#include "TraceRecorder.h"
+#include "ESP32Config.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <LittleFS.h>
+#endif
+
+TraceRecord TraceRecorder::buffer[TRACE_BUFFER_RECORDS];
+uint16_t TraceRecorder::head = 0;
+uint16_t TraceRecorder::count = 0;
+uint16_t TraceRecorder::unflushed = 0;
+uint32_t TraceRecorder::totalRecords = 0;
+uint32_t TraceRecorder::droppedRecords = 0;
+uint32_t TraceRecorder::startMillis = 0;
+volatile bool TraceRecorder::recording = false;
+uint8_t TraceRecorder::pauseCount = 0;
+volatile uint8_t TraceRecorder::pendingCommand = 0;
+bool TraceRecorder::flashMounted = false;
+bool TraceRecorder::flashEnabled = false;
+uint32_t TraceRecorder::flashBytes = 0;
+portMUX_TYPE TraceRecorder::lock = portMUX_INITIALIZER_UNLOCKED;
+
+enum TraceCommand : uint8_t {
+    TRACE_CMD_NONE = 0,
+    TRACE_CMD_START,
+    TRACE_CMD_START_FLASH,
+    TRACE_CMD_STOP,
+    TRACE_CMD_CLEAR
+};
+
+void TraceRecorder::begin() {
+#ifdef ARDUINO_ARCH_ESP32
+    // formatOnFail : seul un système de fichiers illisible est effacé
+    flashMounted = LittleFS.begin(true);
+    if (!flashMounted) {
+        Serial.println("❌ Trace: LittleFS mount failed, recording to RAM only");
+        return;
+    }
+    File file = LittleFS.open(TRACE_FILE_PATH, "r");
+    if (file) {
+        flashBytes = file.size();
+        file.close();
+        Serial.printf("📼 Trace file from a previous session: %u bytes\n", flashBytes);
+    }
+#endif
+}
+
+void TraceRecorder::start(bool toFlash) {
+    portENTER_CRITICAL(&lock);
+    pendingCommand = toFlash ? TRACE_CMD_START_FLASH : TRACE_CMD_START;
+    portEXIT_CRITICAL(&lock);
+}
+
+void TraceRecorder::stop() {
+    portENTER_CRITICAL(&lock);
+    pendingCommand = TRACE_CMD_STOP;
+    portEXIT_CRITICAL(&lock);
+}
+
+void TraceRecorder::clear() {
+    portENTER_CRITICAL(&lock);
+    pendingCommand = TRACE_CMD_CLEAR;
+    portEXIT_CRITICAL(&lock);
+}
+
+bool TraceRecorder::hasPendingCommand() {
+    return pendingCommand != TRACE_CMD_NONE;
+}
+
+void TraceRecorder::applyStart(bool toFlash) {
+    // Termine proprement une session flash précédente avant de tronquer le fichier.
+    // Le fichier n'est tronqué qu'ici : ni au montage, ni pendant un téléchargement
+    // (service() n'applique pas les demandes tant que l'enregistreur est en pause)
+    if (recording) {
+        applyStop();
+    }
+    applyClear();
+    flashEnabled = false;
+    
+#ifdef ARDUINO_ARCH_ESP32
+    if (toFlash) {
+        if (!flashMounted) {
+            Serial.println("❌ Trace: LittleFS not mounted, recording to RAM only");
+        } else {
+            // recordCount = 0 : le nombre d'enregistrements se déduit de la taille du fichier
+            TraceHeader header = { TRACE_MAGIC, TRACE_VERSION, sizeof(TraceRecord), 0, startMillis };
+            File file = LittleFS.open(TRACE_FILE_PATH, "w");
+            if (file) {
+                file.write((const uint8_t*)&header, sizeof(header));
+                file.close();
+                flashBytes = sizeof(header);
+                flashEnabled = true;
+            }
+        }
+    }
+#else
+    (void)toFlash;
+#endif
+    
+    recording = true;
+    Serial.printf("⏺️  Trace recording started (%s)\n", flashEnabled ? "RAM + flash" : "RAM");
+}
+
+void TraceRecorder::applyStop() {
+    if (!recording) return;
+    recording = false;
+    if (flashEnabled) {
+        flushToFlash();
+        flashEnabled = false;
+    }
+    Serial.printf("⏹️  Trace recording stopped (%u records)\n", totalRecords);
+}
+
+void TraceRecorder::applyClear() {
+    portENTER_CRITICAL(&lock);
+    head = 0;
+    count = 0;
+    unflushed = 0;
+    totalRecords = 0;
+    droppedRecords = 0;
+    startMillis = millis();
+    portEXIT_CRITICAL(&lock);
+}
+
+bool TraceRecorder::isRecording() {
+    return recording;
+}
+
+void TraceRecorder::pause() {
+    portENTER_CRITICAL(&lock);
+    pauseCount++;
+    portEXIT_CRITICAL(&lock);
+}
+
+void TraceRecorder::resume() {
+    portENTER_CRITICAL(&lock);
+    if (pauseCount > 0) {
+        pauseCount--;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+bool TraceRecorder::isPaused() {
+    portENTER_CRITICAL(&lock);
+    bool paused = pauseCount > 0;
+    portEXIT_CRITICAL(&lock);
+    return paused;
+}
+
+void TraceRecorder::record(uint8_t type, uint8_t flags, uint16_t value) {
+    if (!recording) return;
+    
+    uint32_t now = millis();
+    portENTER_CRITICAL(&lock);
+    if (pauseCount > 0) {
+        portEXIT_CRITICAL(&lock);
+        return;
+    }
+    TraceRecord& r = buffer[head];
+    r.timestampMs = now;
+    r.type = type;
+    r.flags = flags;
+    r.value = value;
+    head = (head + 1) % TRACE_BUFFER_RECORDS;
+    if (count < TRACE_BUFFER_RECORDS) {
+        count++;
+    }
+    // Vidage flash en retard : les plus anciens enregistrements non vidés sont perdus
+    if (flashEnabled) {
+        if (unflushed < TRACE_BUFFER_RECORDS) {
+            unflushed++;
+        } else {
+            droppedRecords++;
+        }
+    }
+    totalRecords++;
+    portEXIT_CRITICAL(&lock);
+}
+
+void TraceRecorder::recordEcho(long durationUs) {
+    uint16_t value = (durationUs < 0 || durationUs > 0xFFFF) ? 0xFFFF : (uint16_t)durationUs;
+    record(TRACE_ECHO, 0, value);
+}
+
+void TraceRecorder::recordApiCall(TraceRoute route) {
+    record(TRACE_API_CALL, 0, route);
+}
+
+void TraceRecorder::recordGate(int angle, bool open, bool automatic) {
+    uint8_t flags = (open ? TRACE_GATE_OPEN : 0) | (automatic ? TRACE_GATE_AUTO : 0);
+    record(TRACE_GATE, flags, (uint16_t)angle);
+}
+
+void TraceRecorder::service() {
+    // Un téléchargement en cours fige le tampon et le fichier : demandes et
+    // vidage attendent sa fin
+    if (isPaused()) return;
+    
+    portENTER_CRITICAL(&lock);
+    uint8_t command = pendingCommand;
+    pendingCommand = TRACE_CMD_NONE;
+    portEXIT_CRITICAL(&lock);
+    if (command == TRACE_CMD_STOP) {
+        applyStop();
+    } else if (command == TRACE_CMD_CLEAR) {
+        applyClear();
+    } else if (command != TRACE_CMD_NONE) {
+        applyStart(command == TRACE_CMD_START_FLASH);
+    }
+    
+    if (flashEnabled && unflushed >= TRACE_FLUSH_RECORDS) {
+        flushToFlash();
+    }
+}
+
+bool TraceRecorder::flushToFlash() {
+#ifdef ARDUINO_ARCH_ESP32
+    static TraceRecord chunk[64];
+    
+    if (!flashEnabled) return false;
+    
+    File file = LittleFS.open(TRACE_FILE_PATH, "a");
+    if (!file) {
+        Serial.println("❌ Trace: cannot open trace file");
+        return false;
+    }
+    
+    while (true) {
+        uint16_t n = 0;
+        portENTER_CRITICAL(&lock);
+        uint16_t available = unflushed;
+        if (available > 64) available = 64;
+        uint16_t first = (head + TRACE_BUFFER_RECORDS - unflushed) % TRACE_BUFFER_RECORDS;
+        for (; n < available; n++) {
+            chunk[n] = buffer[(first + n) % TRACE_BUFFER_RECORDS];
+        }
+        unflushed -= n;
+        portEXIT_CRITICAL(&lock);
+        
+        if (n == 0) break;
+        
+        size_t bytes = n * sizeof(TraceRecord);
+        if (flashBytes + bytes > TRACE_MAX_FILE_BYTES) {
+            Serial.println("⚠️  Trace file full, flash recording disabled");
+            flashEnabled = false;
+            break;
+        }
+        file.write((const uint8_t*)chunk, bytes);
+        flashBytes += bytes;
+    }
+    
+    file.close();
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t TraceRecorder::getSerializedSize() {
+    return sizeof(TraceHeader) + (size_t)count * sizeof(TraceRecord);
+}
+
+size_t TraceRecorder::serialize(uint8_t* dest, size_t offset, size_t maxLen) {
+    const size_t ringBytes = TRACE_BUFFER_RECORDS * sizeof(TraceRecord);
+    const uint8_t* ring = (const uint8_t*)buffer;
+    size_t written = 0;
+    
+    // Flux virtuel : en-tête puis enregistrements du plus ancien au plus récent,
+    // copiés par segments contigus (au plus deux à cause du bouclage de l'anneau)
+    portENTER_CRITICAL(&lock);
+    TraceHeader header = { TRACE_MAGIC, TRACE_VERSION, sizeof(TraceRecord), count, startMillis };
+    size_t total = sizeof(TraceHeader) + (size_t)count * sizeof(TraceRecord);
+    size_t firstByte = (size_t)((head + TRACE_BUFFER_RECORDS - count) % TRACE_BUFFER_RECORDS) * sizeof(TraceRecord);
+    
+    if (offset < sizeof(TraceHeader)) {
+        size_t n = sizeof(TraceHeader) - offset;
+        if (n > maxLen) n = maxLen;
+        memcpy(dest, (const uint8_t*)&header + offset, n);
+        written = n;
+    }
+    while (written < maxLen && offset + written < total) {
+        size_t ringPos = (firstByte + offset + written - sizeof(TraceHeader)) % ringBytes;
+        size_t n = maxLen - written;
+        if (n > total - (offset + written)) n = total - (offset + written);
+        if (n > ringBytes - ringPos) n = ringBytes - ringPos;
+        memcpy(dest + written, ring + ringPos, n);
+        written += n;
+    }
+    portEXIT_CRITICAL(&lock);
+    
+    return written;
+}
+
+uint16_t TraceRecorder::getBufferedCount() {
+    return count;
+}
+
+uint32_t TraceRecorder::getTotalRecords() {
+    return totalRecords;
+}
+
+uint32_t TraceRecorder::getDroppedRecords() {
+    return droppedRecords;
+}
+
+uint32_t TraceRecorder::getFlashBytes() {
+    return flashBytes;
+}
+
+TraceRoute TraceRecorder::routeFromUrl(const char* url, bool isPost) {
+    if (strcmp(url, "/") == 0) return TRACE_ROUTE_ROOT;
+    if (strcmp(url, "/api/status") == 0) return TRACE_ROUTE_STATUS;
+    if (strcmp(url, "/api/distance") == 0) return TRACE_ROUTE_DISTANCE;
+    if (strcmp(url, "/api/gate") == 0) return isPost ? TRACE_ROUTE_GATE_POST : TRACE_ROUTE_GATE_GET;
+    if (strcmp(url, "/api/photo") == 0) return TRACE_ROUTE_PHOTO;
+    if (strcmp(url, "/api/auto") == 0) return TRACE_ROUTE_AUTO;
+    if (strcmp(url, "/api/esp32cam") == 0) return TRACE_ROUTE_ESP32CAM;
+    if (strcmp(url, "/api/capture") == 0) return TRACE_ROUTE_CAPTURE;
+    if (strcmp(url, "/api/history") == 0) return TRACE_ROUTE_HISTORY;
+    if (strcmp(url, "/api/diagnostics") == 0) return TRACE_ROUTE_DIAGNOSTICS;
+    return TRACE_ROUTE_OTHER;
+}
@@ -3,32 +3,84 @@
 #include "DistanceSensor.h"
 #include "ServoController.h"
 #include "ESP32CAMClient.h"
+#include "CameraPool.h"
 #include "ESP32APIServer.h"
 #include "DebugHelper.h"
+#include "DeadlineMonitor.h"
+#include "SystemState.h"
+#include "TraceRecorder.h"
+#include "TimeSeriesHistory.h"
+#include "GateAutomation.h"
 
 // Global instances
 DistanceSensor distanceSensor(TRIG_PIN, ECHO_PIN);
 ServoController servoController(SERVO_PIN);
 ESP32CAMClient esp32camClient(ESP32CAM_IP);
+ESP32CAMClient rearCamClient(ESP32CAM_REAR_IP);
+CameraPool cameraPool;
 ESP32APIServer apiServer(WEB_SERVER_PORT);
+SystemState systemState;
+TimeSeriesHistory history;
 
 // Timing variables
 unsigned long lastUpdate = 0;
+unsigned long lastStatePublish = 0;
+unsigned long lastCamHealthCheck = 0;
+int loopDeadlineId = -1;
+
+// Ouverture anticipée et refermeture après passage du véhicule
+GateAutomation gateAutomation(distanceSensor, servoController);
+
+// Véhicule attendu au seuil dans moins de APPROACH_LEAD_MS. Appelé pendant
+// readDistance() : la barrière est ouverte plus tard par gateAutomation.update()
+void onVehicleApproaching(float etaMs, float speedCmS, float confidence) {
+    Serial.printf("🚗 Vehicle approaching: ETA %.0f ms at %.1f cm/s (confidence %.2f)\n",
+                  etaMs, speedCmS, confidence);
+    gateAutomation.requestOpen();
+}
+
+// Publie l'instantané lu par les handlers web (seul écrivain : la boucle de contrôle)
+void publishSystemState() {
+    SystemSnapshot snapshot = {};
+    snapshot.distanceCm = distanceSensor.getLastDistance();
+    snapshot.objectDetected = distanceSensor.isObjectDetected(DETECTION_DISTANCE_CM);
+    ApproachEstimator& estimator = distanceSensor.getEstimator();
+    snapshot.approachSpeedCmS = estimator.getApproachSpeed();
+    snapshot.etaMs = estimator.getTimeToThresholdMs(DETECTION_DISTANCE_CM);
+    snapshot.approachConfidence = estimator.getConfidence();
+    snapshot.gateOpen = servoController.isGateOpen();
+    snapshot.gateMoving = servoController.isMoving();
+    snapshot.gateAngle = servoController.getCurrentAngle();
+    snapshot.camerasTotal = cameraPool.getCameraCount();
+    snapshot.camerasHealthy = cameraPool.getHealthyCount();
+    snapshot.camReachable = snapshot.camerasHealthy == snapshot.camerasTotal;
+    snapshot.camCircuit = cameraPool.getWorstCircuit();
+    snapshot.freeHeap = ESP.getFreeHeap();
+    snapshot.uptimeMs = millis();
+    snapshot.controlCore = xPortGetCoreID();
+    systemState.publish(snapshot);
+}
 
 void setup() {
     // Initialiser le système de debug en premier
     DebugHelper::init();
+    DeadlineMonitor::init();
+    loopDeadlineId = DeadlineMonitor::registerTask("loop", DEADLINE_LOOP_MS);
     
     Serial.println("\n=== ESP32 SmartGate API Server Starting ===");
     
+    // LittleFS monté une fois : la trace flash d'avant le reboot reste lisible
+    TraceRecorder::begin();
+    
     // Initialize Distance Sensor
     DebugHelper::logCriticalOperation("Initializing Distance Sensor");
     if (!distanceSensor.init()) {
         Serial.println("❌ Failed to initialize Distance Sensor!");
         return;
     }
+    distanceSensor.getEstimator().setApproachCallback(onVehicleApproaching,
+                                                      DETECTION_DISTANCE_CM, APPROACH_LEAD_MS);
     Serial.println("✅ Distance Sensor initialized");
-    DebugHelper::feedWatchdog();
     
     // Initialize Servo Controller
     DebugHelper::logCriticalOperation("Initializing Servo Controller");
@@ -37,48 +89,83 @@ void setup() {
         return;
     }
     Serial.println("✅ Servo Controller initialized");
-    DebugHelper::feedWatchdog();
     
-    // Initialize ESP32-CAM Client
-    DebugHelper::logCriticalOperation("Initializing ESP32-CAM Client");
-    if (!esp32camClient.init()) {
+    // Initialize ESP32-CAM Clients (front + rear) and camera pool
+    DebugHelper::logCriticalOperation("Initializing ESP32-CAM Pool");
+    if (!esp32camClient.init() || !rearCamClient.init()) {
         Serial.println("❌ Failed to initialize ESP32-CAM Client!");
         return;
     }
-    Serial.println("✅ ESP32-CAM Client initialized");
-    DebugHelper::feedWatchdog();
+    cameraPool.addCamera("front", &esp32camClient);
+    cameraPool.addCamera("rear", &rearCamClient);
+    if (!cameraPool.begin()) {
+        Serial.println("❌ Failed to start camera pool!");
+        return;
+    }
+    Serial.println("✅ ESP32-CAM Pool initialized");
     
     // Initialize API Server (includes WiFi connection)
     DebugHelper::logCriticalOperation("Initializing API Server (WiFi + HTTP)");
-    if (!apiServer.init(&distanceSensor, &servoController, &esp32camClient)) {
+    if (!apiServer.init(&distanceSensor, &servoController, &cameraPool, &systemState, &history)) {
         Serial.println("❌ Failed to initialize API Server!");
         return;
     }
-    DebugHelper::feedWatchdog();
+    
+    // Premier instantané avant d'accepter des requêtes (caméras sondées en parallèle)
+    cameraPool.triggerProbe();
+    cameraPool.waitForRound(CAM_REACHABLE_TIMEOUT_MS + 500);
+    lastCamHealthCheck = millis();
+    publishSystemState();
     
     apiServer.begin();
     Serial.println("✅ API Server initialized");
     
     Serial.println("🎉 === System Ready ===");
     Serial.printf("🌐 Access the web interface at: http://%s\n", apiServer.getIPAddress().c_str());
-    Serial.printf("📷 Communicating with ESP32-CAM at: %s\n", esp32camClient.getIP().c_str());
+    Serial.printf("📷 Camera pool: %d cameras, %d reachable\n",
+                  cameraPool.getCameraCount(), cameraPool.getHealthyCount());
+    Serial.printf("📈 History buffer: %u bytes (fixed)\n", (unsigned)TimeSeriesHistory::getMemoryBytes());
+    Serial.printf("🧵 Control loop on core %d\n", xPortGetCoreID());
+    if (xPortGetCoreID() != CONTROL_CORE) {
+        Serial.printf("⚠️  Control loop expected on core %d\n", CONTROL_CORE);
+    }
     
-    DebugHelper::feedWatchdog();
+    // Superviseur indépendant de loop() : un blocage de la boucle elle-même est persisté
+    DeadlineMonitor::startSupervisor();
+    DeadlineMonitor::feedIfHealthy();
 }
 
 void loop() {
     unsigned long currentTime = millis();
+    DeadlineMonitor::begin(loopDeadlineId);
     
-    // Surveillance mémoire et watchdog en continu
+    // Surveillance mémoire
     DebugHelper::checkMemory();
-    DebugHelper::feedWatchdog();
     
     // Update distance sensor SANS LOG pour éviter le spam
     distanceSensor.update();
-    DebugHelper::feedWatchdog();
+    // Hors du créneau "sensor" : le mouvement servo a son propre budget
+    gateAutomation.update(millis());
+    
+    // Vidage des traces vers la flash hors des handlers web
+    TraceRecorder::service();
+    
+    // Capture mise en attente derrière un sondage : lancée dès sa fin
+    cameraPool.service();
+    
+    // Santé des caméras : sondage parallèle non bloquant par les tâches du pool
+    if (currentTime - lastCamHealthCheck >= CAM_HEALTH_INTERVAL_MS) {
+        cameraPool.triggerProbe();
+        lastCamHealthCheck = currentTime;
+    }
+    
+    if (currentTime - lastStatePublish >= STATE_PUBLISH_INTERVAL_MS) {
+        publishSystemState();
+        lastStatePublish = currentTime;
+    }
     
-    // Auto photo detection disabled to prevent failures
-    // apiServer.handleAutoPhoto();
+    // Capture automatique sur détection (non bloquante, désactivée par défaut)
+    apiServer.handleAutoPhoto();
     
     // Monitoring moins fréquent pour économiser CPU
     if (currentTime - lastUpdate >= UPDATE_INTERVAL_MS * 15) { // Every 30 seconds au lieu de 10
@@ -89,10 +176,15 @@ void loop() {
                      ESP.getFreeHeap());
         
         lastUpdate = currentTime;
-        DebugHelper::feedWatchdog();
     }
     
-    // Délai avec watchdog feeding
+    // Historique : un point par itération, coût constant
+    history.add(currentTime, distanceSensor.getLastDistance(),
+                distanceSensor.isObjectDetected(DETECTION_DISTANCE_CM),
+                servoController.getCurrentAngle(), ESP.getFreeHeap(), millis() - currentTime);
+    DeadlineMonitor::end(loopDeadlineId);
+    
+    // Watchdog alimenté uniquement si aucune tâche surveillée n'est bloquée
+    DeadlineMonitor::feedIfHealthy();
     delay(200);
-    DebugHelper::feedWatchdog();
 }
\ No newline at end of file
@@ -0,0 +1,197 @@
+// Test hôte du contrôle d'admission sur horloge virtuelle : places réservées
+// au contrôle, seaux à jetons, éviction de la table d'IP, seuils de heap, puis
+// inondation de lectures pendant que l'opérateur commande la barrière.
+//
+//   pio test -e native -f test_admission
+
+#include <unity.h>
+#include "Arduino.h"
+#include "ESP32Config.h"
+#include "AdmissionController.h"
+
+#include <vector>
+
+#define HEAP_OK 200000
+#define IP(n) (0x0A000000u + (n))   // 10.0.0.n
+#define OPERATOR_IP IP(200)
+
+void setUp() {
+    HostArduino::setMillis(100000);
+}
+void tearDown() {}
+
+static int drain(AdmissionController& ac, uint32_t ip, AdmissionController::RequestClass cls) {
+    // Consomme tous les jetons d'une IP sans occuper de place en vol
+    int admitted = 0;
+    while (ac.admit(ip, cls, HEAP_OK) == AdmissionController::ADMITTED) {
+        ac.release();
+        admitted++;
+    }
+    return admitted;
+}
+
+static void test_reserved_control_slots() {
+    AdmissionController ac;
+    int reads = 0;
+    for (int i = 0; i < ADMISSION_MAX_INFLIGHT; i++) {
+        if (ac.admit(IP(i + 1), AdmissionController::READ, HEAP_OK) == AdmissionController::ADMITTED) {
+            reads++;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ADMISSION_MAX_INFLIGHT - ADMISSION_CONTROL_RESERVED, reads,
+                                  "reads stop short of the reserved slots");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(AdmissionController::OVERLOADED,
+                                  ac.admit(IP(50), AdmissionController::READ, HEAP_OK), "next read overloaded (503)");
+    int controls = 0;
+    for (int i = 0; i < ADMISSION_CONTROL_RESERVED; i++) {
+        if (ac.admit(OPERATOR_IP, AdmissionController::CONTROL, HEAP_OK) == AdmissionController::ADMITTED) {
+            controls++;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ADMISSION_CONTROL_RESERVED, controls, "control still admitted into the reserved slots");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(AdmissionController::OVERLOADED,
+                                  ac.admit(OPERATOR_IP, AdmissionController::CONTROL, HEAP_OK),
+                                  "control overloaded once every slot is taken");
+    for (int i = 0; i < ADMISSION_MAX_INFLIGHT + 3; i++) {
+        ac.release();
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, ac.getInFlight(), "release never underflows");
+}
+
+static void test_token_buckets() {
+    AdmissionController ac;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ADMISSION_READ_BURST, drain(ac, IP(1), AdmissionController::READ), "read burst then 429");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(AdmissionController::RATE_LIMITED,
+                                  ac.admit(IP(1), AdmissionController::READ, HEAP_OK),
+                                  "empty bucket reported as rate limited");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ADMISSION_CONTROL_BURST, drain(ac, IP(1), AdmissionController::CONTROL),
+                                  "control bucket independent of the read bucket");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ADMISSION_READ_BURST, drain(ac, IP(2), AdmissionController::READ), "buckets are per IP");
+    delay(1000 / ADMISSION_READ_RATE_PER_SEC - 1);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, drain(ac, IP(1), AdmissionController::READ), "no token before 1/rate");
+    delay(1);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, drain(ac, IP(1), AdmissionController::READ), "one token after 1/rate (milli-token refill)");
+    delay(60000);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ADMISSION_READ_BURST, drain(ac, IP(1), AdmissionController::READ), "refill capped at burst");
+}
+
+static void test_ip_table_eviction() {
+    AdmissionController ac;
+    drain(ac, IP(1), AdmissionController::READ);
+    delay(1);
+    drain(ac, IP(2), AdmissionController::READ);
+    for (int i = 3; i <= ADMISSION_MAX_CLIENTS; i++) {
+        delay(1);
+        ac.admit(IP(i), AdmissionController::READ, HEAP_OK);
+        ac.release();
+    }
+    // IP(1) redevient active : IP(2) est maintenant la moins récente
+    delay(1);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(AdmissionController::RATE_LIMITED,
+                                  ac.admit(IP(1), AdmissionController::READ, HEAP_OK),
+                                  "tracked IP keeps its empty bucket");
+    delay(1);
+    ac.admit(IP(100), AdmissionController::READ, HEAP_OK);
+    ac.release();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(AdmissionController::RATE_LIMITED,
+                                  ac.admit(IP(1), AdmissionController::READ, HEAP_OK), "recently seen IP not evicted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(AdmissionController::ADMITTED,
+                                  ac.admit(IP(2), AdmissionController::READ, HEAP_OK),
+                                  "least recently seen IP evicted, comes back with a full bucket");
+    ac.release();
+
+    // Limite connue : une rotation sur plus d'IP que la table contourne les seaux
+    int rotated = 0;
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i <= ADMISSION_MAX_CLIENTS; i++) {
+            delay(1);
+            if (ac.admit(IP(300 + i), AdmissionController::READ, HEAP_OK) == AdmissionController::ADMITTED) {
+                rotated++;
+            }
+            ac.release();
+        }
+    }
+    printf("Rotating over %d IPs: %d/%d admitted (only the in-flight cap applies)\n",
+           ADMISSION_MAX_CLIENTS + 1, rotated, 4 * (ADMISSION_MAX_CLIENTS + 1));
+}
+
+static void test_heap_thresholds() {
+    AdmissionController ac;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(AdmissionController::ADMITTED,
+                                  ac.admit(IP(1), AdmissionController::READ, ADMISSION_HEAP_WATERMARK),
+                                  "read admitted at the watermark");
+    ac.release();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(AdmissionController::LOW_MEMORY,
+                                  ac.admit(IP(1), AdmissionController::READ, ADMISSION_HEAP_WATERMARK - 1),
+                                  "read rejected below the watermark");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(AdmissionController::ADMITTED,
+                                  ac.admit(IP(1), AdmissionController::CONTROL, ADMISSION_HEAP_WATERMARK - 1),
+                                  "control admitted between critical and watermark");
+    ac.release();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(AdmissionController::LOW_MEMORY,
+                                  ac.admit(IP(1), AdmissionController::CONTROL, ADMISSION_HEAP_CRITICAL - 1),
+                                  "everything rejected below critical");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(2, ac.getCounters().lowMemory, "low-memory rejects counted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, ac.getInFlight(), "low-memory rejects take no slot");
+}
+
+static void test_read_flood_vs_operator() {
+    // 20 IP à 50 lectures/s chacune, 100 ms par requête, pendant que
+    // l'opérateur envoie une commande par seconde
+    AdmissionController ac;
+    const int floodIPs = 20;
+    const int durationMs = 10000;
+    const int serviceMs = 100;
+    std::vector<unsigned long> completions;
+    int controlSent = 0, controlOk = 0, readsSent = 0, readsOk = 0;
+    int maxInFlight = 0;
+    unsigned long start = millis();
+
+    for (int t = 0; t < durationMs; t++) {
+        unsigned long now = millis();
+        for (size_t i = 0; i < completions.size();) {
+            if (completions[i] <= now) {
+                ac.release();
+                completions[i] = completions.back();
+                completions.pop_back();
+            } else {
+                i++;
+            }
+        }
+        if (t % 20 == 0) {
+            for (int ip = 0; ip < floodIPs; ip++) {
+                readsSent++;
+                if (ac.admit(IP(ip + 1), AdmissionController::READ, HEAP_OK) == AdmissionController::ADMITTED) {
+                    readsOk++;
+                    completions.push_back(now + serviceMs);
+                }
+            }
+        }
+        if (t % 1000 == 500) {
+            controlSent++;
+            if (ac.admit(OPERATOR_IP, AdmissionController::CONTROL, HEAP_OK) == AdmissionController::ADMITTED) {
+                controlOk++;
+                completions.push_back(now + serviceMs);
+            }
+        }
+        maxInFlight = max(maxInFlight, (int)ac.getInFlight());
+        delay(1);
+    }
+    const AdmissionController::Counters& c = ac.getCounters();
+    printf("Flood %lu ms: reads %d/%d admitted, control %d/%d, max in flight %d\n",
+           millis() - start, readsOk, readsSent, controlOk, controlSent, maxInFlight);
+    printf("Shed: %u rate limited, %u overloaded\n", c.rateLimited, c.overloaded);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(controlSent, controlOk, "every operator command admitted during the flood");
+    TEST_ASSERT_TRUE_MESSAGE(maxInFlight <= ADMISSION_MAX_INFLIGHT, "in-flight cap respected");
+    TEST_ASSERT_TRUE_MESSAGE(c.rateLimited > 0 && c.overloaded > 0, "flood shed by both buckets and in-flight cap");
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reserved_control_slots);
+    RUN_TEST(test_token_buckets);
+    RUN_TEST(test_ip_table_eviction);
+    RUN_TEST(test_heap_thresholds);
+    RUN_TEST(test_read_flood_vs_operator);
+    return UNITY_END();
+}
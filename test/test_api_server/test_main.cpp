@@ -0,0 +1,193 @@
+// Test hôte d'ESP32APIServer : les vrais handlers, compilés contre les
+// shims ESPAsyncWebServer / ArduinoJson / LittleFS de tools/host, avec le
+// vrai contrôle d'admission. Vérifie que chaque route répond, les champs
+// publiés par l'instantané, le téléchargement de trace flash et le
+// délestage (heap, requêtes en vol).
+//
+//   pio test -e native -f test_api_server
+
+#include <unity.h>
+#include "Arduino.h"
+#include "ESP32Config.h"
+#include "ESP32APIServer.h"
+#include "ArduinoJson.h"
+
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static DistanceSensor sensor(TRIG_PIN, ECHO_PIN);
+static ServoController servo(SERVO_PIN);
+static ESP32CAMClient front(ESP32CAM_IP), rear(ESP32CAM_REAR_IP);
+static CameraPool pool;
+static SystemState state;
+static TimeSeriesHistory history;
+static ESP32APIServer api(WEB_SERVER_PORT);
+static uint8_t nextClient = 1;
+
+struct Reply {
+    int code;
+    std::string body;
+};
+
+// Une requête d'un client distinct (pas de seau à jetons partagé), connexion
+// fermée aussitôt la réponse produite
+static Reply call(WebRequestMethodComposite method, const char* url) {
+    HostArduino::setMillis(millis() + 100);
+    AsyncWebServerRequest request(method, url, IPAddress(10, 0, 0, nextClient++));
+    AsyncWebServer::hostInstance()->hostHandle(&request);
+    Reply reply = { 0, "" };
+    if (request.hostResponse()) {
+        reply.code = request.hostResponse()->hostCode();
+        String body = request.hostResponse()->hostBody();
+        reply.body.assign(body.c_str(), body.length());
+    }
+    request.hostDisconnect();
+    return reply;
+}
+
+static bool has(const Reply& reply, const char* text) {
+    return reply.body.find(text) != std::string::npos;
+}
+
+static void publish(float distance, float speed, float eta) {
+    SystemSnapshot s = {};
+    s.distanceCm = distance;
+    s.objectDetected = distance < DETECTION_DISTANCE_CM;
+    s.approachSpeedCmS = speed;
+    s.etaMs = eta;
+    s.approachConfidence = 0.75f;
+    s.gateAngle = 95;
+    s.camerasTotal = 2;
+    s.freeHeap = 150000;
+    s.uptimeMs = millis();
+    state.publish(s);
+}
+
+void setUp() {
+    HostArduino::setFreeHeap(150000);
+}
+void tearDown() {}
+
+static void test_every_route_answers() {
+    const char* routes[] = { "/", "/api/status", "/api/distance", "/api/gate", "/api/esp32cam",
+                             "/api/capture", "/api/history?metric=distance&range=60000&points=50",
+                             "/api/history?metric=free_heap&range=600000", "/api/admission",
+                             "/api/diagnostics", "/api/trace" };
+    for (const char* url : routes) {
+        Reply reply = call(HTTP_GET, url);
+        printf("GET %-52s %d, %zu bytes\n", url, reply.code, reply.body.size());
+        TEST_ASSERT_EQUAL_INT_MESSAGE(200, reply.code, url);
+        TEST_ASSERT_TRUE_MESSAGE(reply.body.size() > 0, url);
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(404, call(HTTP_GET, "/api/nothing").code, "unknown route");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(400, call(HTTP_GET, "/api/history?metric=bogus").code, "unknown metric");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, HostJson::internalOverflows, "JSON shim large enough for every route");
+}
+
+static void test_snapshot_fields() {
+    publish(42.5f, 80.0f, 281.0f);
+    Reply distance = call(HTTP_GET, "/api/distance");
+    TEST_ASSERT_TRUE_MESSAGE(has(distance, "\"distance\":42.5"), distance.body.c_str());
+    TEST_ASSERT_TRUE_MESSAGE(has(distance, "\"approach_speed\":80"), distance.body.c_str());
+    TEST_ASSERT_TRUE_MESSAGE(has(distance, "\"eta_ms\":281"), distance.body.c_str());
+    TEST_ASSERT_TRUE_MESSAGE(has(distance, "\"confidence\":0.75"), distance.body.c_str());
+
+    publish(40.0f, 0.0f, -1.0f);
+    char version[32];
+    snprintf(version, sizeof(version), "\"state_version\":%u", state.getVersion());
+    Reply status = call(HTTP_GET, "/api/status");
+    TEST_ASSERT_TRUE_MESSAGE(has(status, version), status.body.c_str());
+}
+
+static void test_history_streams_points() {
+    for (uint32_t t = 0; t < 120000; t += 200) {
+        history.add(millis() + t, 150.0f - (t % 20000) / 200.0f, false, 95, 150000, 5);
+    }
+    HostArduino::setMillis(millis() + 120000);
+    Reply reply = call(HTTP_GET, "/api/history?metric=distance&range=60000&points=50");
+    TEST_ASSERT_TRUE_MESSAGE(has(reply, "\"metric\":\"distance\""), reply.body.c_str());
+    TEST_ASSERT_TRUE_MESSAGE(has(reply, "\"points\":[["), "history has points");
+}
+
+static void test_trace_flash_download() {
+    char root[] = "/tmp/smartgate_fsXXXXXX";
+    TEST_ASSERT_NOT_NULL(mkdtemp(root));
+    HostFS::setRoot(root);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(404, call(HTTP_GET, "/api/trace?source=flash").code, "no trace file yet");
+
+    std::string path = std::string(root) + TRACE_FILE_PATH;
+    FILE* f = fopen(path.c_str(), "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    std::string content(3000, 'x');
+    fwrite(content.data(), 1, content.size(), f);
+    fclose(f);
+
+    Reply reply = call(HTTP_GET, "/api/trace?source=flash");
+    TEST_ASSERT_EQUAL_INT(200, reply.code);
+    TEST_ASSERT_EQUAL_INT_MESSAGE((int)content.size(), (int)reply.body.size(), "whole file served");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, api.getAdmission().getInFlight(), "slot released by the download's end hook");
+    remove(path.c_str());
+    rmdir(root);
+}
+
+static void test_control_routes() {
+    Reply gate = call(HTTP_POST, "/api/gate?action=open");
+    TEST_ASSERT_EQUAL_INT(200, gate.code);
+    TEST_ASSERT_TRUE_MESSAGE(has(gate, "\"gate\":true"), gate.body.c_str());
+    TEST_ASSERT_EQUAL_INT_MESSAGE(400, call(HTTP_POST, "/api/gate").code, "missing action");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(503, call(HTTP_POST, "/api/capture").code, "pool not started");
+    TEST_ASSERT_EQUAL_INT(200, call(HTTP_POST, "/api/trace?action=stop").code);
+}
+
+static void test_low_heap_sheds_reads_first() {
+    HostArduino::setFreeHeap(ADMISSION_HEAP_WATERMARK - 1);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(503, call(HTTP_GET, "/api/status").code, "read shed under the watermark");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(200, call(HTTP_POST, "/api/gate?action=close").code, "control still admitted");
+    HostArduino::setFreeHeap(ADMISSION_HEAP_CRITICAL - 1);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(503, call(HTTP_POST, "/api/gate?action=close").code, "everything shed when critical");
+}
+
+static void test_inflight_limit_keeps_control_slots() {
+    // Connexions lentes : les réponses ne partent pas, les places restent prises
+    std::vector<AsyncWebServerRequest*> open;
+    for (int i = 0; i < ADMISSION_MAX_INFLIGHT - ADMISSION_CONTROL_RESERVED; i++) {
+        AsyncWebServerRequest* r = new AsyncWebServerRequest(HTTP_GET, "/api/status", IPAddress(10, 1, 0, i + 1));
+        AsyncWebServer::hostInstance()->hostHandle(r);
+        TEST_ASSERT_EQUAL_INT(200, r->hostResponse()->hostCode());
+        open.push_back(r);
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(503, call(HTTP_GET, "/api/distance").code, "read refused when read slots are full");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(200, call(HTTP_POST, "/api/gate?action=open").code, "reserved control slot");
+    for (AsyncWebServerRequest* r : open) {
+        r->hostDisconnect();
+        delete r;
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, api.getAdmission().getInFlight(), "every slot released on disconnect");
+    TEST_ASSERT_EQUAL_INT(200, call(HTTP_GET, "/api/distance").code);
+}
+
+int main() {
+    HostArduino::setMillis(100000);
+    DeadlineMonitor::init();
+    sensor.init();
+    servo.init();
+    pool.addCamera("front", &front);
+    pool.addCamera("rear", &rear);
+    publish(150.0f, 0.0f, -1.0f);
+    if (!api.init(&sensor, &servo, &pool, &state, &history)) {
+        printf("api.init() failed\n");
+        return 1;
+    }
+    api.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_every_route_answers);
+    RUN_TEST(test_snapshot_fields);
+    RUN_TEST(test_history_streams_points);
+    RUN_TEST(test_trace_flash_download);
+    RUN_TEST(test_control_routes);
+    RUN_TEST(test_low_heap_sheds_reads_first);
+    RUN_TEST(test_inflight_limit_keeps_control_slots);
+    return UNITY_END();
+}
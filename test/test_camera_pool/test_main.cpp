@@ -0,0 +1,131 @@
+// Test hôte du CameraPool : tâches FreeRTOS = threads, HTTPClient simulé,
+// horloge réelle. Vérifie que la latence d'une ronde est celle de la caméra
+// la plus lente et non la somme, la capture mise en attente derrière un
+// sondage, puis l'agrégation (santé, disjoncteurs, sondages).
+//
+//   pio test -e native -f test_camera_pool
+
+#include <unity.h>
+#include "Arduino.h"
+#include "ESP32Config.h"
+#include "HTTPClient.h"
+#include "CameraPool.h"
+#include "DeadlineMonitor.h"
+
+#define CONNECT_MS 20
+#define TOLERANCE_MS 60     // Ordonnancement des threads et réveil de l'event group
+
+static const char* hosts[] = { "cam-front", "cam-rear", "cam-side" };
+static const long latencies[] = { 300, 900, 600 };
+static const uint32_t slowest = 900;
+
+static ESP32CAMClient front(hosts[0]), rear(hosts[1]), side(hosts[2]);
+static CameraPool pool;
+
+void setUp() {}
+void tearDown() {}
+
+static CameraPool::RoundInfo runRound(bool capture) {
+    bool started = capture ? pool.triggerCapture() == CameraPool::TRIGGER_STARTED : pool.triggerProbe();
+    TEST_ASSERT_TRUE_MESSAGE(started, "round started");
+    pool.waitForRound(CAM_PHOTO_TIMEOUT_MS + 1000);
+    return pool.getLastRound();
+}
+
+static void test_probe_fan_out() {
+    CameraPool::RoundInfo probe = runRound(false);
+    printf("Probe round: %u ms (%u/%u ok)\n", probe.latencyMs, probe.succeeded, probe.cameras);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(3, probe.succeeded, "probe: all cameras answered");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(3, pool.getHealthyCount(), "probe: all cameras healthy");
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32_MESSAGE(slowest, probe.latencyMs, "probe latency >= slowest camera");
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(slowest + TOLERANCE_MS, probe.latencyMs, "probe latency ~ max(latencies)");
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32_MESSAGE(latencies[1], pool.getLastProbe(1).latencyMs,
+                                                "per-camera probe latency recorded");
+}
+
+static void test_capture_fan_out() {
+    for (int n = 0; n < 3; n++) {
+        // requestPhoto() refuse deux captures à moins de 3 s : avance l'horloge
+        HostArduino::setMillis(millis() + 3100);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(CameraPool::TRIGGER_STARTED, pool.triggerCapture(), "capture started");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(CameraPool::TRIGGER_BUSY, pool.triggerCapture(),
+                                      "second capture refused while one is in flight");
+        TEST_ASSERT_FALSE_MESSAGE(pool.triggerProbe(), "probe skipped while a capture is in flight");
+        pool.waitForRound(CAM_PHOTO_TIMEOUT_MS + 1000);
+        CameraPool::RoundInfo round = pool.getLastRound();
+        printf("Capture round %u: %u ms (%u/%u ok)\n", round.id, round.latencyMs, round.succeeded, round.cameras);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(3, round.succeeded, "capture: all cameras succeeded");
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32_MESSAGE(slowest, round.latencyMs, "capture latency >= slowest camera");
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(slowest + TOLERANCE_MS, round.latencyMs,
+                                                 "capture latency ~ max(latencies), not the sum");
+    }
+}
+
+static void test_capture_queued_behind_probe() {
+    HostArduino::setMillis(millis() + 3100);
+    TEST_ASSERT_TRUE_MESSAGE(pool.triggerProbe(), "probe started");
+    uint32_t probeId = pool.getLastRound().id;
+    
+    uint32_t captureId = 0;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(CameraPool::TRIGGER_QUEUED, pool.triggerCapture(&captureId),
+                                  "capture during a probe is queued, not refused");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(probeId + 1, captureId, "queued capture gets the next round id");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(CameraPool::TRIGGER_BUSY, pool.triggerCapture(), "only one capture queued");
+    TEST_ASSERT_FALSE_MESSAGE(pool.triggerProbe(), "no probe ahead of the queued capture");
+    
+    // loop() : service() ne lance rien tant que le sondage tourne
+    pool.service();
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(probeId, pool.getLastRound().id, "capture waits for the probe");
+    pool.waitForRound(CAM_REACHABLE_TIMEOUT_MS + 1000);
+    pool.service();
+    
+    CameraPool::RoundInfo round = pool.getLastRound();
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(captureId, round.id, "queued capture started after the probe");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(CameraPool::CMD_CAPTURE, round.command, "round is a capture");
+    pool.waitForRound(CAM_PHOTO_TIMEOUT_MS + 1000);
+    round = pool.getLastRound();
+    printf("Queued capture: waited %u ms behind the probe, round %u ms (%u/%u ok)\n",
+           round.queuedMs, round.latencyMs, round.succeeded, round.cameras);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(3, round.succeeded, "queued capture: all cameras succeeded");
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32_MESSAGE(slowest, round.queuedMs, "queue time = probe duration");
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(slowest + TOLERANCE_MS, round.queuedMs, "no wait beyond the probe");
+}
+
+static void test_aggregation() {
+    HostHTTP::removeEndpoint("cam-side");
+    for (int n = 0; n < CAM_BREAKER_FAILURE_THRESHOLD; n++) {
+        runRound(false);
+    }
+    CameraPool::RoundInfo degraded = runRound(false);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, pool.getHealthyCount(), "offline camera counted unhealthy");
+    TEST_ASSERT_FALSE_MESSAGE(pool.isReachable(2), "offline camera not reachable");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(CircuitBreaker::OPEN, pool.getWorstCircuit(), "worst circuit reports the open breaker");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, degraded.succeeded, "healthy cameras still answer");
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(slowest + TOLERANCE_MS, degraded.latencyMs,
+                                             "round with an open circuit still bounded by the slowest healthy camera");
+}
+
+int main() {
+    HostArduino::useRealClock(true);
+    HostArduino::setMillis(100000);
+    DeadlineMonitor::init();
+
+    for (int i = 0; i < 3; i++) {
+        HostHTTP::setEndpoint(hosts[i], CONNECT_MS, latencies[i] - CONNECT_MS, 200);
+    }
+    pool.addCamera("front", &front);
+    pool.addCamera("rear", &rear);
+    pool.addCamera("side", &side);
+    if (!pool.begin()) {
+        printf("pool.begin() failed\n");
+        return 1;
+    }
+    printf("Cameras: 300 / 900 / 600 ms -> slowest %u ms, sum 1800 ms\n", slowest);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_probe_fan_out);
+    RUN_TEST(test_capture_fan_out);
+    RUN_TEST(test_capture_queued_behind_probe);
+    RUN_TEST(test_aggregation);
+    return UNITY_END();
+}
@@ -0,0 +1,120 @@
+// Test hôte du disjoncteur caméra : le vrai client ESP32-CAM sur HTTPClient
+// simulé et horloge virtuelle. Temps avant ouverture, coût d'un fast-fail,
+// récupération half-open, et caméra bloquée bornée par l'échéance de l'appel
+// (connexion + lecture).
+//
+//   pio test -e native -f test_circuit_breaker
+
+#include <unity.h>
+#include "Arduino.h"
+#include "ESP32Config.h"
+#include "HTTPClient.h"
+#include "ESP32CAMClient.h"
+
+#include <chrono>
+
+static ESP32CAMClient* cam;
+
+void setUp() {}
+void tearDown() {}
+
+static void test_healthy_camera() {
+    TEST_ASSERT_TRUE_MESSAGE(cam->isReachable(), "probe ok");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ESP32CAMClient::CALL_OK, cam->getLastResult(), "call reported ok");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(CircuitBreaker::CLOSED, cam->getBreaker().getState(), "circuit closed");
+}
+
+static void test_time_to_open() {
+    // La caméra ne répond plus (lecture bloquée)
+    HostHTTP::setEndpoint("cam", 20, -1, 200);
+    CircuitBreaker& breaker = cam->getBreaker();
+    unsigned long outageStart = millis();
+    int calls = 0;
+    while (breaker.getState() != CircuitBreaker::OPEN && calls < 10) {
+        unsigned long callStart = millis();
+        cam->isReachable();
+        calls++;
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(CAM_REACHABLE_TIMEOUT_MS, millis() - callStart,
+                                                 "hung call bounded by its deadline");
+    }
+    unsigned long timeToOpen = millis() - outageStart;
+    printf("Opened after %d calls, %lu ms\n", calls, timeToOpen);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(CAM_BREAKER_FAILURE_THRESHOLD, calls, "opens after the failure threshold");
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(CAM_BREAKER_FAILURE_THRESHOLD * CAM_REACHABLE_TIMEOUT_MS, timeToOpen,
+                                             "time to open <= threshold x call deadline");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ESP32CAMClient::CALL_TRANSPORT_ERROR, cam->getLastResult(),
+                                  "hang reported as transport error");
+}
+
+static void test_fast_fail_while_open() {
+    // Aucun appel réseau, coût mesuré en temps réel
+    unsigned long before = HostHTTP::getRequestCount("cam");
+    const int n = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        cam->isReachable();
+    }
+    double ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / n;
+    printf("Fast-fail: %.1f ns per rejected call on host\n", ns);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(before, HostHTTP::getRequestCount("cam"), "no network call while open");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ESP32CAMClient::CALL_CIRCUIT_OPEN, cam->getLastResult(), "reported as circuit open");
+}
+
+static void test_half_open_recovery() {
+    // La caméra revient pendant la fenêtre ouverte
+    CircuitBreaker& breaker = cam->getBreaker();
+    HostHTTP::setEndpoint("cam", 20, 80, 200);
+    delay(breaker.getRetryInMs());
+    TEST_ASSERT_EQUAL_INT_MESSAGE(CircuitBreaker::HALF_OPEN, breaker.getState(), "half-open after the open window");
+    TEST_ASSERT_TRUE_MESSAGE(cam->isReachable(), "probe call succeeds");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(CircuitBreaker::CLOSED, breaker.getState(), "circuit closed again");
+    printf("Recovery: %lu ms from first trip to close\n", breaker.getLastRecoveryMs());
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32_MESSAGE(CAM_BREAKER_OPEN_MS, breaker.getLastRecoveryMs(),
+                                                "recovery >= open window");
+}
+
+static void test_deadline_budget() {
+    // Connexion et lecture partagent le budget au lieu de l'avoir chacune
+    CircuitBreaker& breaker = cam->getBreaker();
+    HostHTTP::setEndpoint("cam", 20, -1, 200);
+    unsigned long start = millis();
+    cam->requestPhoto(millis() + 1000);
+    unsigned long elapsed = millis() - start;
+    printf("Hung photo with 1000 ms deadline: %lu ms\n", elapsed);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(1000, elapsed, "hung read returns within the deadline, not 2x");
+
+    HostHTTP::setEndpoint("cam", -1, 0, 200);
+    start = millis();
+    cam->isReachable(millis() + 1000);
+    elapsed = millis() - start;
+    printf("Hung connect with 1000 ms deadline: %lu ms\n", elapsed);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(1000 * CAM_CONNECT_BUDGET_PCT / 100, elapsed,
+                                             "hung connect uses only its share");
+
+    breaker.reset();
+    HostHTTP::setEndpoint("cam", 20, 80, 200);
+    TEST_ASSERT_FALSE_MESSAGE(cam->isReachable(millis() + CAM_MIN_CALL_BUDGET_MS - 1), "call skipped below minimum budget");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ESP32CAMClient::CALL_DEADLINE_EXCEEDED, cam->getLastResult(),
+                                  "reported as deadline exceeded");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(CircuitBreaker::CLOSED, breaker.getState(), "circuit stays closed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, breaker.getConsecutiveFailures(),
+                                  "exhausted budget does not count against the camera");
+}
+
+int main() {
+    HostArduino::setMillis(100000);
+    HostHTTP::setEndpoint("cam", 20, 80, 200);
+    ESP32CAMClient client("cam");
+    cam = &client;
+    printf("Breaker: %d failures to open, %d ms open, %d probe(s)\n",
+           CAM_BREAKER_FAILURE_THRESHOLD, CAM_BREAKER_OPEN_MS, CAM_BREAKER_HALF_OPEN_PROBES);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_healthy_camera);
+    RUN_TEST(test_time_to_open);
+    RUN_TEST(test_fast_fail_while_open);
+    RUN_TEST(test_half_open_recovery);
+    RUN_TEST(test_deadline_budget);
+    return UNITY_END();
+}
@@ -0,0 +1,133 @@
+// Test hôte de DeadlineMonitor : coût d'un point de contrôle begin()/end()
+// et comportement sur horloge virtuelle (dépassement, blocage qui coupe le
+// watchdog, anneau persisté).
+//
+//   pio test -e native -f test_deadline
+
+#include <unity.h>
+#include "Arduino.h"
+#include "ESP32Config.h"
+#include "DeadlineMonitor.h"
+
+#include <chrono>
+
+static int loopId, servoId, camId;
+
+void setUp() {}
+void tearDown() {}
+
+static void test_checkpoint_cost() {
+    const int n = 10000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        DeadlineScope scope(loopId);
+    }
+    double ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / n;
+    printf("Cost: %.1f ns per checkpoint (begin + end) on host\n", ns);
+    printf("Static footprint: %zu bytes for %d tasks\n",
+           sizeof(DeadlineMonitor::TaskInfo) * DEADLINE_MAX_TASKS, DEADLINE_MAX_TASKS);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, DeadlineMonitor::getTask(loopId).overruns, "no overrun from the timing loop");
+}
+
+static void test_overrun_within_and_beyond_budget() {
+    HostArduino::setMillis(10000);
+
+    DeadlineMonitor::begin(servoId);
+    delay(500);
+    DeadlineMonitor::end(servoId);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, DeadlineMonitor::getTask(servoId).overruns, "servo move within budget");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, DeadlineMonitor::getPersistedCount(), "nothing persisted");
+
+    // Dépassement simple : enregistré, watchdog toujours alimenté
+    DeadlineMonitor::begin(servoId);
+    delay(DEADLINE_SERVO_MS + 100);
+    DeadlineMonitor::end(servoId);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, DeadlineMonitor::getTask(servoId).overruns, "servo overrun counted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, DeadlineMonitor::getPersistedCount(), "overrun persisted");
+    TEST_ASSERT_TRUE_MESSAGE(DeadlineMonitor::feedIfHealthy(), "watchdog still fed after a finished overrun");
+}
+
+static void test_hang_stops_watchdog() {
+    // Au-delà de hangMs le watchdog n'est plus alimenté
+    DeadlineMonitor::begin(camId);
+    delay(DEADLINE_CAMERA_MS * DEADLINE_HANG_FACTOR - 1);
+    TEST_ASSERT_TRUE_MESSAGE(DeadlineMonitor::feedIfHealthy(), "slow camera call below hang limit is tolerated");
+    delay(2);
+    TEST_ASSERT_FALSE_MESSAGE(DeadlineMonitor::feedIfHealthy(), "hung camera call stops watchdog feeding");
+    TEST_ASSERT_FALSE_MESSAGE(DeadlineMonitor::feedIfHealthy(), "hang still reported on next check");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, DeadlineMonitor::getPersistedCount(), "hang persisted once");
+    OverrunRecord hang = DeadlineMonitor::getPersisted(0);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("cam_front", hang.name, "latest record is the hang");
+    TEST_ASSERT_TRUE_MESSAGE(hang.ongoing == 1, "hang recorded while ongoing");
+
+    // Fin de l'opération bloquée : pas de second enregistrement, santé rétablie
+    DeadlineMonitor::end(camId);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, DeadlineMonitor::getPersistedCount(), "finished hang not recorded twice");
+    TEST_ASSERT_TRUE_MESSAGE(DeadlineMonitor::feedIfHealthy(), "watchdog fed again once the call returns");
+}
+
+static void test_supervisor_catches_stalled_loop() {
+    // Blocage de loop() elle-même : seul le superviseur (esp_timer) appelle check()
+    DeadlineMonitor::begin(loopId);
+    for (int tick = 0; tick < 40; tick++) {
+        delay(DEADLINE_CHECK_INTERVAL_MS);
+        DeadlineMonitor::check();
+    }
+    OverrunRecord stall = DeadlineMonitor::getPersisted(0);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("loop", stall.name, "stalled loop persisted by supervisor before its end()");
+    TEST_ASSERT_TRUE_MESSAGE(stall.ongoing == 1, "stall recorded while ongoing");
+    TEST_ASSERT_TRUE_MESSAGE(DEADLINE_LOOP_MS * DEADLINE_HANG_FACTOR + DEADLINE_CHECK_INTERVAL_MS <
+                             DEADLINE_WDT_TIMEOUT_S * 1000UL,
+                             "loop hang detected before the task watchdog fires");
+    DeadlineMonitor::end(loopId);
+}
+
+static void test_persisted_ring_and_reboot() {
+    // Seuls les DEADLINE_PERSISTED_OVERRUNS plus récents restent
+    for (int i = 0; i < DEADLINE_PERSISTED_OVERRUNS + 3; i++) {
+        DeadlineMonitor::begin(loopId);
+        delay(DEADLINE_LOOP_MS + 1 + i);
+        DeadlineMonitor::end(loopId);
+    }
+    OverrunRecord newest = DeadlineMonitor::getPersisted(0);
+    OverrunRecord oldest = DeadlineMonitor::getPersisted(DEADLINE_PERSISTED_OVERRUNS - 1);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(DEADLINE_PERSISTED_OVERRUNS, DeadlineMonitor::getPersistedCount(), "ring capped");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(DEADLINE_LOOP_MS + 1 + DEADLINE_PERSISTED_OVERRUNS + 2, newest.durationMs,
+                                     "newest first");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(DEADLINE_LOOP_MS + 4, oldest.durationMs, "oldest kept is the 4th loop overrun");
+
+    // Reboot simulé : la mémoire RTC (ici statique) survit, le compteur de boot avance
+    uint32_t boot = DeadlineMonitor::getBootCount();
+    DeadlineMonitor::init();
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(boot + 1, DeadlineMonitor::getBootCount(), "boot counter incremented");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(DEADLINE_PERSISTED_OVERRUNS, DeadlineMonitor::getPersistedCount(),
+                                  "records survive reboot");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, DeadlineMonitor::getTaskCount(), "task table reset on boot");
+}
+
+static void test_task_table_full() {
+    for (int i = 0; i < DEADLINE_MAX_TASKS; i++) {
+        DeadlineMonitor::registerTask("t", 10);
+    }
+    int extra = DeadlineMonitor::registerTask("extra", 10);
+    DeadlineMonitor::begin(extra);
+    DeadlineMonitor::end(extra);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(-1, extra, "registration beyond capacity rejected, id ignored");
+}
+
+int main() {
+    DeadlineMonitor::init();
+    loopId = DeadlineMonitor::registerTask("loop", DEADLINE_LOOP_MS);
+    servoId = DeadlineMonitor::registerTask("servo", DEADLINE_SERVO_MS);
+    camId = DeadlineMonitor::registerTask("cam_front", DEADLINE_CAMERA_MS);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_checkpoint_cost);
+    RUN_TEST(test_overrun_within_and_beyond_budget);
+    RUN_TEST(test_hang_stops_watchdog);
+    RUN_TEST(test_supervisor_catches_stalled_loop);
+    RUN_TEST(test_persisted_ring_and_reboot);
+    RUN_TEST(test_task_table_full);
+    return UNITY_END();
+}
@@ -0,0 +1,158 @@
+// Test hôte de GateAutomation : vrais DistanceSensor, ServoController et
+// estimateur sur horloge virtuelle, échos injectés comme au rejeu de traces
+// (HostArduino::setNextPulse). Vérifie que l'ouverture anticipée se fait hors
+// du créneau "sensor" et que la barrière se referme quand le véhicule quitte
+// le champ du capteur, y compris quand il ne renvoie plus d'écho.
+//
+//   pio test -e native -f test_gate_automation
+
+#include <unity.h>
+#include "Arduino.h"
+#include "ESP32Config.h"
+#include "DeadlineMonitor.h"
+#include "DistanceSensor.h"
+#include "ServoController.h"
+#include "GateAutomation.h"
+
+#define LOOP_MS 200         // delay() de fin de loop()
+#define NO_ECHO -1.0f       // Timeout pulseIn : rien devant le capteur
+
+static DistanceSensor sensor(TRIG_PIN, ECHO_PIN);
+static ServoController servo(SERVO_PIN);
+static GateAutomation automation(sensor, servo, true);
+static int sensorTaskIndex = -1;
+
+static void onApproach(float, float, float) {
+    automation.requestOpen();
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Une itération de loop() : lecture capteur, puis automatisme hors du créneau capteur
+static void loopOnce(float cm) {
+    HostArduino::setNextPulse(cm < 0 ? 0 : (long)(cm / 0.017f));
+    sensor.update();
+    automation.update(millis());
+    delay(LOOP_MS);
+}
+
+static void hold(float cm, unsigned long ms) {
+    unsigned long end = millis() + ms;
+    while (millis() < end) {
+        loopOnce(cm);
+    }
+}
+
+// Approche à vitesse constante jusqu'à stopCm, après un champ vide (NO_ECHO)
+// pour que l'estimateur suive le véhicule dès son premier écho
+static void approach(float fromCm, float stopCm, float speedCmS) {
+    unsigned long start = millis();
+    float cm = fromCm;
+    while (cm > stopCm) {
+        cm = max(stopCm, fromCm - speedCmS * (millis() - start) / 1000.0f);
+        loopOnce(cm);
+    }
+}
+
+static uint32_t sensorOverruns() {
+    return DeadlineMonitor::getTask(sensorTaskIndex).overruns;
+}
+
+static void test_early_open_outside_sensor_slot() {
+    hold(NO_ECHO, 3000);
+    approach(150, 10, 50);
+    TEST_ASSERT_TRUE_MESSAGE(servo.isGateOpen(), "gate opened for the approaching vehicle");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, automation.getStats().opens, "one early open");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, sensorOverruns(), "servo move not charged to the sensor slot");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, DeadlineMonitor::getPersistedCount(), "no overrun persisted");
+    printf("Announcement -> gate open: %u ms\n", automation.getStats().lastOpenDelayMs);
+}
+
+static void test_parked_vehicle_keeps_gate_open() {
+    hold(10, 20000);
+    TEST_ASSERT_TRUE_MESSAGE(servo.isGateOpen(), "valid echoes under the threshold keep the gate open");
+    TEST_ASSERT_TRUE_MESSAGE(automation.isActive(), "still supervised");
+}
+
+static void test_vehicle_leaves_into_open_space() {
+    // Le véhicule sort du champ : plus aucun écho, getLastDistance() reste à 10 cm
+    unsigned long left = millis();
+    while (servo.isGateOpen() && millis() - left < 30000) {
+        loopOnce(NO_ECHO);
+    }
+    unsigned long closedAfter = millis() - left;
+    printf("Echo lost -> gate closed: %lu ms\n", closedAfter);
+    TEST_ASSERT_FALSE_MESSAGE(servo.isGateOpen(), "gate closed although lastDistance stayed under the threshold");
+    TEST_ASSERT_TRUE_MESSAGE(sensor.isObjectDetected(DETECTION_DISTANCE_CM), "stale distance still reads as detected");
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(APPROACH_CLOSE_AFTER_CLEAR_MS + 1000, closedAfter,
+                                             "closed about APPROACH_CLOSE_AFTER_CLEAR_MS after the last echo");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, automation.getStats().closedPassed, "counted as a passed vehicle");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, sensorOverruns(), "closing not charged to the sensor slot either");
+}
+
+static void test_vehicle_leaves_past_far_wall() {
+    hold(NO_ECHO, 3000);
+    approach(150, 10, 50);
+    TEST_ASSERT_TRUE_MESSAGE(servo.isGateOpen(), "second vehicle: gate opened");
+    hold(10, 2000);
+    unsigned long left = millis();
+    while (servo.isGateOpen() && millis() - left < 30000) {
+        loopOnce(150);
+    }
+    TEST_ASSERT_FALSE_MESSAGE(servo.isGateOpen(), "gate closed once the wall is seen again");
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(APPROACH_CLOSE_AFTER_CLEAR_MS + 1000, millis() - left,
+                                             "closed about APPROACH_CLOSE_AFTER_CLEAR_MS after departure");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(2, automation.getStats().closedPassed, "second passage counted");
+}
+
+static void test_announced_vehicle_turns_away() {
+    hold(NO_ECHO, 3000);
+    approach(150, 60, 50);
+    TEST_ASSERT_TRUE_MESSAGE(servo.isGateOpen(), "gate opened on the announcement");
+    unsigned long opened = millis();
+    while (servo.isGateOpen() && millis() - opened < 30000) {
+        loopOnce(150);
+    }
+    TEST_ASSERT_FALSE_MESSAGE(servo.isGateOpen(), "gate closed without a vehicle");
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32_MESSAGE(APPROACH_OPEN_TIMEOUT_MS - 2000, millis() - opened,
+                                                "kept open for the open timeout");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, automation.getStats().closedNoShow, "counted as a no-show");
+}
+
+static void test_api_close_ends_supervision() {
+    hold(NO_ECHO, 3000);
+    approach(150, 10, 50);
+    TEST_ASSERT_TRUE_MESSAGE(automation.isActive(), "early open supervised");
+    servo.closeGate();
+    loopOnce(10);
+    TEST_ASSERT_FALSE_MESSAGE(automation.isActive(), "operator close ends supervision");
+    // L'estimateur peut réannoncer le véhicule arrêté (nouveau suivi après des aberrations)
+    hold(10, 5000);
+    TEST_ASSERT_FALSE_MESSAGE(servo.isGateOpen(), "no reopen for the same vehicle");
+    hold(NO_ECHO, APPROACH_CLOSE_AFTER_CLEAR_MS + 1000);
+    approach(150, 10, 50);
+    TEST_ASSERT_TRUE_MESSAGE(servo.isGateOpen(), "next vehicle opens again once the zone was clear");
+}
+
+int main() {
+    HostArduino::setMillis(100000);
+    DeadlineMonitor::init();
+    sensor.init();
+    servo.init();
+    sensor.getEstimator().setApproachCallback(onApproach, DETECTION_DISTANCE_CM, APPROACH_LEAD_MS);
+    for (int i = 0; i < DeadlineMonitor::getTaskCount(); i++) {
+        if (strcmp(DeadlineMonitor::getTask(i).name, "sensor") == 0) {
+            sensorTaskIndex = i;
+        }
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_early_open_outside_sensor_slot);
+    RUN_TEST(test_parked_vehicle_keeps_gate_open);
+    RUN_TEST(test_vehicle_leaves_into_open_space);
+    RUN_TEST(test_vehicle_leaves_past_far_wall);
+    RUN_TEST(test_announced_vehicle_turns_away);
+    RUN_TEST(test_api_close_ends_supervision);
+    return UNITY_END();
+}
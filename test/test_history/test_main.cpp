@@ -0,0 +1,139 @@
+// Test hôte de TimeSeriesHistory : seaux 1 s / 10 s (min/max/moy),
+// sous-échantillonnage LTTB (extrémités, nombre de points, pic conservé) et
+// choix du niveau de résolution une fois les anneaux repliés.
+//
+//   pio test -e native -f test_history
+
+#include <unity.h>
+#include "Arduino.h"
+#include "ESP32Config.h"
+#include "TimeSeriesHistory.h"
+
+#include <vector>
+
+static TimeSeriesHistory h1, h2, h3, h4;   // ~18 KB chacun, hors pile
+
+void setUp() {}
+void tearDown() {}
+
+static void collect(const HistoryPoint& point, void* context) {
+    static_cast<std::vector<HistoryPoint>*>(context)->push_back(point);
+}
+
+static std::vector<HistoryPoint> queryAll(TimeSeriesHistory& h, TimeSeriesHistory::Tier tier,
+                                          uint32_t now, uint32_t rangeMs, size_t maxPoints = 1000) {
+    std::vector<HistoryPoint> points;
+    h.query(TimeSeriesHistory::METRIC_DISTANCE, tier, now, rangeMs, maxPoints, collect, &points);
+    return points;
+}
+
+static void addDistance(TimeSeriesHistory& h, uint32_t t, float cm) {
+    h.add(t, cm, cm < DETECTION_DISTANCE_CM, 95, 200000, 5);
+}
+
+static bool increasing(const std::vector<HistoryPoint>& points) {
+    for (size_t i = 1; i < points.size(); i++) {
+        if (points[i].timestampMs <= points[i - 1].timestampMs) return false;
+    }
+    return true;
+}
+
+static void test_buckets() {
+    printf("Memory: %zu bytes per history\n", TimeSeriesHistory::getMemoryBytes());
+
+    // Seconde 100 : 10, 20, 30, 40, 50 cm ; l'échantillon de la seconde 101 la clôt
+    const uint32_t t0 = 100000;
+    for (int i = 0; i < 5; i++) {
+        addDistance(h1, t0 + i * 200, 10.0f * (i + 1));
+    }
+    addDistance(h1, t0 + 1000, 99.0f);
+    std::vector<HistoryPoint> s = queryAll(h1, TimeSeriesHistory::TIER_1S, t0 + 1000, 60000);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, s.size(), "one closed 1 s bucket");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(t0, s[0].timestampMs, "1 s bucket stamped at its first sample");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.05f, 10, s[0].min, "1 s bucket min");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.05f, 50, s[0].max, "1 s bucket max");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.05f, 30, s[0].value, "1 s bucket average");
+
+    // Secondes 101..109 : un échantillon à 99 cm sauf un pic à 5 cm en 105 ;
+    // la seconde 110 clôt le seau 10 s [100, 110)
+    for (int sec = 101; sec < 110; sec++) {
+        if (sec > 101) addDistance(h1, sec * 1000, 99.0f);
+        if (sec == 105) addDistance(h1, sec * 1000 + 500, 5.0f);
+    }
+    addDistance(h1, 110000, 99.0f);
+    addDistance(h1, 111000, 99.0f);
+    std::vector<HistoryPoint> ten = queryAll(h1, TimeSeriesHistory::TIER_10S, 111000, 600000);
+    // 5 échantillons de moyenne 30, 9 à 99, 1 à 5 : moyenne pondérée par échantillon
+    float avg = (5 * 30.0f + 9 * 99.0f + 5.0f) / 15;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, ten.size(), "one closed 10 s bucket");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(t0, ten[0].timestampMs, "10 s bucket stamped at its first sample");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.05f, 5, ten[0].min, "10 s bucket keeps the real min of its samples");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.05f, 99, ten[0].max, "10 s bucket keeps the real max of its samples");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.2f, avg, ten[0].value, "10 s bucket average weighted by sample count");
+    std::vector<HistoryPoint> secs = queryAll(h1, TimeSeriesHistory::TIER_1S, 111000, 60000);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(11, secs.size(), "eleven 1 s buckets");
+    TEST_ASSERT_TRUE_MESSAGE(increasing(secs), "1 s buckets in order");
+}
+
+static void test_lttb() {
+    // 300 échantillons bruts à 200 ms, un pic isolé au milieu
+    const uint32_t t0 = 50000;
+    for (int i = 0; i < 300; i++) {
+        addDistance(h2, t0 + i * 200, i == 150 ? 3.0f : 100.0f + (i % 7));
+    }
+    uint32_t now = t0 + 299 * 200;
+    std::vector<HistoryPoint> all = queryAll(h2, TimeSeriesHistory::TIER_RAW, now, 60000);
+    std::vector<HistoryPoint> down = queryAll(h2, TimeSeriesHistory::TIER_RAW, now, 60000, 50);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(300, all.size(), "300 raw points in range");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(50, down.size(), "downsampled to exactly maxPoints");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(all.front().timestampMs, down.front().timestampMs, "first point preserved");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(all.back().timestampMs, down.back().timestampMs, "last point preserved");
+    bool spike = false;
+    for (const HistoryPoint& p : down) {
+        if (fabsf(p.value - 3.0f) < 0.05f) spike = true;
+    }
+    TEST_ASSERT_TRUE_MESSAGE(spike, "isolated spike kept");
+    TEST_ASSERT_TRUE_MESSAGE(increasing(down), "downsampled points in time order");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, queryAll(h2, TimeSeriesHistory::TIER_RAW, now, 60000, 2).size(),
+                                  "maxPoints < 3 returns the first points");
+    TEST_ASSERT_TRUE_MESSAGE(queryAll(h2, TimeSeriesHistory::TIER_RAW, now, 60000, 0).empty(),
+                             "maxPoints 0 returns nothing");
+}
+
+static void test_tier_selection_across_wrap() {
+    // Boucle lente (200 ms) : l'anneau brut couvre 64 s
+    uint32_t t = 0;
+    for (int i = 0; i < HISTORY_RAW_POINTS / 2; i++, t += 200) addDistance(h3, t, 50);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(TimeSeriesHistory::TIER_RAW, h3.selectTier(t, 600000),
+                                  "raw ring not full: raw holds everything");
+    for (int i = 0; i < HISTORY_RAW_POINTS * 3; i++, t += 200) addDistance(h3, t, 50);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(TimeSeriesHistory::TIER_RAW, h3.selectTier(t, 60000), "200 ms cadence: raw covers 60 s");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(TimeSeriesHistory::TIER_1S, h3.selectTier(t, 70000), "beyond raw coverage: 1 s buckets");
+    std::vector<HistoryPoint> wrapped = queryAll(h3, TimeSeriesHistory::TIER_RAW, t, 60000);
+    TEST_ASSERT_FALSE_MESSAGE(wrapped.empty(), "wrapped raw query returns points");
+    TEST_ASSERT_TRUE_MESSAGE(increasing(wrapped), "wrapped raw query in order");
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(60000, t - wrapped.front().timestampMs, "wrapped raw query within range");
+
+    // Boucle rapide (50 ms) : l'anneau brut ne couvre plus que 16 s
+    t = 0;
+    for (int i = 0; i < HISTORY_RAW_POINTS * 3; i++, t += 50) addDistance(h4, t, 50);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(TimeSeriesHistory::TIER_RAW, h4.selectTier(t, 15000), "50 ms cadence: raw covers 15 s");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(TimeSeriesHistory::TIER_1S, h4.selectTier(t, 60000),
+                                  "50 ms cadence: 60 s falls back to 1 s");
+
+    // Après repli de l'anneau 1 s (180 s), 5 min passent au niveau 10 s
+    for (int i = 0; i < 250 * 20; i++, t += 50) addDistance(h4, t, 50);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(TimeSeriesHistory::TIER_1S, h4.selectTier(t, 170000), "wrapped 1 s ring covers 170 s");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(TimeSeriesHistory::TIER_10S, h4.selectTier(t, 300000), "5 min needs the 10 s tier");
+    std::vector<HistoryPoint> secs = queryAll(h4, TimeSeriesHistory::TIER_1S, t, 170000);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32_MESSAGE(169, secs.size(), "wrapped 1 s query covers the range");
+    TEST_ASSERT_TRUE_MESSAGE(increasing(secs), "wrapped 1 s query in order");
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_buckets);
+    RUN_TEST(test_lttb);
+    RUN_TEST(test_tier_selection_across_wrap);
+    return UNITY_END();
+}
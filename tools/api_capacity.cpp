@@ -0,0 +1,495 @@
+// Capacité hôte d'ESP32APIServer : les vrais handlers (src/ESP32APIServer.cpp
+// compilé contre les shims ESPAsyncWebServer / ArduinoJson / LittleFS de
+// tools/host) et le vrai contrôle d'admission, soumis à N clients virtuels
+// sur une horloge virtuelle. Déterministe et bien plus rapide que le temps réel.
+//
+// Mesuré sur le code réel, par requête :
+// - octets du corps, octets retenus par la réponse jusqu'à la fermeture,
+//   pic d'allocations pendant le handler (hooks operator new/delete ;
+//   ArduinoJson 7 alloue tous ses documents sur le heap) ;
+// - décisions d'admission (429 / 503) et temps bloqué dans la tâche AsyncTCP
+//   (POST /api/gate attend le servo 500 ms : les autres requêtes font la queue).
+// Modélisé, à calibrer sur la carte (free_heap de /api/status) :
+// - heap libre au repos, coût d'une connexion AsyncTCP/lwIP, tampon d'envoi
+//   TCP, nombre max de PCB, débit et RTT du lien, temps CPU d'un handler.
+// Le heap libre vu par l'admission avant chaque requête est
+//   heap au repos - connexions ouvertes x coût - octets retenus - tampons d'envoi.
+//
+// Compilation :
+//   g++ -O2 -std=gnu++17 -pthread -Itools/host -Iinclude tools/host/*.cpp
+//       $(ls src/*.cpp | grep -v main.cpp) tools/api_capacity.cpp -o api_capacity
+//
+// Usage :
+//   ./api_capacity [--clients 10] [--rate 1] [--duration 60] [--seed 1]
+//                  [--mix status=50,distance=30,history=5,esp32cam=5,gate=5,root=5]
+//                  [--heap 140000] [--conn-bytes 2500] [--snd-buf 5744] [--max-tcp 16]
+//                  [--link-kbps 2000] [--rtt-ms 20] [--cpu-ms 2] [--block-overhead 8]
+//   ./api_capacity --sweep [options]      # 1 à 64 clients, une ligne par charge
+
+#include "Arduino.h"
+#include "ESP32Config.h"
+#include "ESP32APIServer.h"
+#include "DeadlineMonitor.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+// --- Comptage des allocations ---
+// Seules les allocations faites pendant une section mesurée sont comptées ;
+// l'en-tête du bloc le mémorise pour que leur libération plus tard (fermeture
+// de connexion) soit décomptée, et seulement elle.
+
+struct alignas(16) AllocHeader {
+    size_t size;
+    bool counted;
+};
+
+static bool counting = false;
+static size_t blockOverhead = 8;        // En-tête multi_heap par bloc (ESP-IDF)
+static long long liveBytes = 0;
+static long long peakBytes = 0;
+
+static void* countedAlloc(size_t size) {
+    AllocHeader* h = (AllocHeader*)malloc(sizeof(AllocHeader) + size);
+    if (!h) throw std::bad_alloc();
+    h->size = size;
+    h->counted = counting;
+    if (counting) {
+        liveBytes += (long long)(size + blockOverhead);
+        if (liveBytes > peakBytes) peakBytes = liveBytes;
+    }
+    return h + 1;
+}
+
+static void countedFree(void* p) {
+    if (!p) return;
+    AllocHeader* h = (AllocHeader*)p - 1;
+    if (h->counted) {
+        liveBytes -= (long long)(h->size + blockOverhead);
+    }
+    free(h);
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+
+// --- Modèle ---
+
+struct CapacityOptions {
+    int clients = 10;
+    double ratePerClient = 1.0;         // Requêtes/s par client, en boucle ouverte
+    double durationS = 60;
+    unsigned seed = 1;
+    std::string mix = "status=50,distance=30,history=5,esp32cam=5,gate=5,root=5";
+    long heapAtRest = 140000;           // free_heap de /api/status sans client
+    long connBytes = 2500;              // AsyncClient + AsyncWebServerRequest + PCB/pbufs lwIP
+    long sndBuf = 5744;                 // CONFIG_LWIP_TCP_SND_BUF_DEFAULT
+    int maxTcp = 16;                    // CONFIG_LWIP_MAX_ACTIVE_TCP
+    double linkKbps = 2000;             // Débit utile par connexion
+    double rttMs = 20;
+    double cpuMs = 2;                   // Temps CPU d'un handler hors attentes (delay)
+};
+
+struct Route {
+    const char* name;
+    WebRequestMethodComposite method;
+    const char* url;
+};
+
+// Mêmes URL que l'interface web et tools/loadtest.py ; POST /api/capture est
+// absent (pool de caméras non démarré sur l'hôte : toujours 503)
+static const Route ROUTES[] = {
+    { "root", HTTP_GET, "/" },
+    { "status", HTTP_GET, "/api/status" },
+    { "distance", HTTP_GET, "/api/distance" },
+    { "gate_get", HTTP_GET, "/api/gate" },
+    { "gate", HTTP_POST, "/api/gate?action=open" },
+    { "photo", HTTP_GET, "/api/photo" },
+    { "esp32cam", HTTP_GET, "/api/esp32cam" },
+    { "capture_get", HTTP_GET, "/api/capture" },
+    { "history", HTTP_GET, "/api/history?metric=distance&range=600000&points=100" },
+    { "admission", HTTP_GET, "/api/admission" },
+    { "diagnostics", HTTP_GET, "/api/diagnostics" },
+    { "trace", HTTP_GET, "/api/trace" },
+};
+static const int ROUTE_COUNT = sizeof(ROUTES) / sizeof(ROUTES[0]);
+
+struct RouteStats {
+    uint64_t requests = 0;
+    uint64_t ok = 0;
+    uint64_t rateLimited = 0;
+    uint64_t busy = 0;
+    uint64_t other = 0;
+    uint64_t refused = 0;               // Pas de PCB libre : connexion refusée par lwIP
+    uint64_t bodyBytes = 0;
+    long long retainedBytes = 0;
+    long long peakBytes = 0;
+    unsigned long handlerMs = 0;
+};
+
+struct CapacityReport {
+    RouteStats routes[ROUTE_COUNT];
+    int maxOpen = 0;
+    int maxInFlight = 0;
+    size_t maxQueue = 0;
+    std::vector<unsigned long> waitMs;  // Arrivée -> début du handler
+    long minHeap = 0;
+    unsigned long minHeapAtMs = 0;
+    long firstWarningMs = -1;           // Premier passage sous MEMORY_WARNING_THRESHOLD
+    unsigned long belowWarningMs = 0;
+    AdmissionController::Counters admission = {};
+};
+
+struct Connection {
+    AsyncWebServerRequest* request;
+    int route;
+    unsigned long arrivedMs;
+    long sendBytes;                     // Tampon d'envoi occupé pendant le transfert
+};
+
+enum EventType { EV_CLOSE, EV_SERVER_FREE, EV_ARRIVAL };
+
+struct Event {
+    unsigned long at;
+    EventType type;
+    uint64_t seq;
+    int client;
+    Connection* conn;
+    bool operator>(const Event& o) const {
+        if (at != o.at) return at > o.at;
+        if (type != o.type) return type > o.type;   // Fermetures d'abord à instant égal
+        return seq > o.seq;
+    }
+};
+
+static DistanceSensor sensor(TRIG_PIN, ECHO_PIN);
+static ServoController servo(SERVO_PIN);
+static ESP32CAMClient front(ESP32CAM_IP), rear(ESP32CAM_REAR_IP);
+static CameraPool pool;
+static SystemState state;
+static TimeSeriesHistory history;
+static ESP32APIServer api(WEB_SERVER_PORT);
+
+static bool parseMix(const std::string& mix, std::vector<double>& weights) {
+    weights.assign(ROUTE_COUNT, 0.0);
+    size_t pos = 0;
+    while (pos < mix.size()) {
+        size_t end = mix.find(',', pos);
+        if (end == std::string::npos) end = mix.size();
+        std::string item = mix.substr(pos, end - pos);
+        size_t eq = item.find('=');
+        std::string name = item.substr(0, eq);
+        int found = -1;
+        for (int r = 0; r < ROUTE_COUNT; r++) {
+            if (name == ROUTES[r].name) found = r;
+        }
+        if (found < 0 || eq == std::string::npos) {
+            fprintf(stderr, "Unknown mix entry '%s'\n", item.c_str());
+            return false;
+        }
+        weights[found] = atof(item.c_str() + eq + 1);
+        pos = end + 1;
+    }
+    return true;
+}
+
+// État du firmware après plusieurs minutes de fonctionnement : historique
+// rempli, tampon de trace plein, instantané publié
+static void warmUp() {
+    unsigned long now = millis();
+    for (unsigned long t = 0; t < 1800000; t += 200) {
+        float distance = 150.0f - (float)((t / 200) % 100);
+        history.add(now + t, distance, distance < DETECTION_DISTANCE_CM, 95, (uint32_t)140000, 5);
+    }
+    HostArduino::setMillis(now + 1800000);
+
+    TraceRecorder::start();
+    TraceRecorder::service();
+    for (int i = 0; i < TRACE_BUFFER_RECORDS; i++) {
+        TraceRecorder::recordEcho(8700);
+    }
+
+    SystemSnapshot s = {};
+    s.distanceCm = 150.0f;
+    s.approachSpeedCmS = 0.0f;
+    s.etaMs = -1.0f;
+    s.gateAngle = 95;
+    s.camerasTotal = 2;
+    s.freeHeap = 140000;
+    s.uptimeMs = millis();
+    state.publish(s);
+}
+
+static long freeHeapNow(const CapacityOptions& opt, int open, long sendBytes, long long live) {
+    return opt.heapAtRest - (long)open * opt.connBytes - sendBytes - (long)live;
+}
+
+static CapacityReport simulate(const CapacityOptions& opt, const std::vector<double>& weights) {
+    CapacityReport report;
+    std::mt19937 rng(opt.seed);
+    std::exponential_distribution<double> interArrival(opt.ratePerClient / 1000.0);
+    std::discrete_distribution<int> pickRoute(weights.begin(), weights.end());
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    std::queue<Connection*> pending;
+    uint64_t seq = 0;
+
+    const unsigned long start = millis();
+    const unsigned long end = start + (unsigned long)(opt.durationS * 1000.0);
+    const AdmissionController::Counters before = api.getAdmission().getCounters();
+    for (int c = 0; c < opt.clients; c++) {
+        events.push({ start + (unsigned long)interArrival(rng), EV_ARRIVAL, seq++, c, nullptr });
+    }
+
+    int open = 0;
+    long sendBytes = 0;
+    bool serverBusy = false;
+    bool gateOpen = false;
+    const long long baseline = liveBytes;
+    report.minHeap = opt.heapAtRest;
+
+    auto sampleHeap = [&](unsigned long at, long heap) {
+        if (heap < report.minHeap) {
+            report.minHeap = heap;
+            report.minHeapAtMs = at - start;
+        }
+        if (heap < MEMORY_WARNING_THRESHOLD && report.firstWarningMs < 0) {
+            report.firstWarningMs = (long)(at - start);
+        }
+    };
+
+    auto startNext = [&](unsigned long at) {
+        Connection* conn = pending.front();
+        pending.pop();
+        report.waitMs.push_back(at - conn->arrivedMs);
+        RouteStats& stats = report.routes[conn->route];
+
+        // La tâche AsyncTCP traite une requête à la fois
+        HostArduino::setMillis(at);
+        long heap = freeHeapNow(opt, open, sendBytes, liveBytes - baseline);
+        HostArduino::setFreeHeap(heap > 0 ? (uint32_t)heap : 0);
+        sampleHeap(at, heap);
+
+        long long liveBefore = liveBytes;
+        peakBytes = liveBytes;
+        counting = true;
+        AsyncWebServer::hostInstance()->hostHandle(conn->request);
+        counting = false;
+        int inFlight = api.getAdmission().getInFlight();
+        if (inFlight > report.maxInFlight) report.maxInFlight = inFlight;
+
+        long long peak = peakBytes - liveBefore;
+        sampleHeap(at, freeHeapNow(opt, open, sendBytes, peakBytes - baseline));
+        stats.peakBytes = std::max(stats.peakBytes, peak);
+        stats.retainedBytes += liveBytes - liveBefore;
+
+        unsigned long done = millis() + (unsigned long)opt.cpuMs;
+        stats.handlerMs += done - at;
+        AsyncWebServerResponse* response = conn->request->hostResponse();
+        size_t length = response ? response->hostLength() : 0;
+        int code = response ? response->hostCode() : 0;
+        stats.bodyBytes += length;
+        if (code >= 200 && code < 400) stats.ok++;
+        else if (code == 429) stats.rateLimited++;
+        else if (code == 503) stats.busy++;
+        else stats.other++;
+
+        conn->sendBytes = std::min((long)length + 256, opt.sndBuf);   // Corps + en-têtes HTTP
+        sendBytes += conn->sendBytes;
+        unsigned long transferMs = (unsigned long)(opt.rttMs + (length + 256) * 8.0 / opt.linkKbps);
+        serverBusy = true;
+        events.push({ done, EV_SERVER_FREE, seq++, -1, nullptr });
+        events.push({ done + transferMs, EV_CLOSE, seq++, -1, conn });
+    };
+
+    while (!events.empty()) {
+        Event ev = events.top();
+        events.pop();
+        unsigned long at = ev.at;
+
+        if (ev.type == EV_ARRIVAL) {
+            if (at >= end) continue;
+            events.push({ at + 1 + (unsigned long)interArrival(rng), EV_ARRIVAL, seq++, ev.client, nullptr });
+            int route = pickRoute(rng);
+            RouteStats& stats = report.routes[route];
+            stats.requests++;
+            if (open >= opt.maxTcp) {
+                stats.refused++;
+                continue;
+            }
+            std::string url = ROUTES[route].url;
+            if (ROUTES[route].method == HTTP_POST && url.rfind("/api/gate", 0) == 0) {
+                // Alterne ouverture et fermeture comme un opérateur
+                url = gateOpen ? "/api/gate?action=close" : "/api/gate?action=open";
+                gateOpen = !gateOpen;
+            }
+            Connection* conn = new Connection{
+                new AsyncWebServerRequest(ROUTES[route].method, url.c_str(),
+                                          IPAddress(10, 0, (ev.client >> 8) & 0xFF, (ev.client & 0xFF) + 1)),
+                route, at, 0 };
+            open++;
+            report.maxOpen = std::max(report.maxOpen, open);
+            sampleHeap(at, freeHeapNow(opt, open, sendBytes, liveBytes - baseline));
+            pending.push(conn);
+            report.maxQueue = std::max(report.maxQueue, pending.size());
+            if (!serverBusy) startNext(std::max(at, millis()));
+        } else if (ev.type == EV_SERVER_FREE) {
+            serverBusy = false;
+            if (!pending.empty()) startNext(std::max(at, millis()));
+        } else {
+            Connection* conn = ev.conn;
+            conn->request->hostDisconnect();
+            delete conn->request;
+            sendBytes -= conn->sendBytes;
+            open--;
+            delete conn;
+        }
+
+        // Temps passé sous le seuil d'alerte jusqu'au prochain événement
+        long heap = freeHeapNow(opt, open, sendBytes, liveBytes - baseline);
+        if (heap < MEMORY_WARNING_THRESHOLD && !events.empty()) {
+            report.belowWarningMs += events.top().at > at ? events.top().at - at : 0;
+        }
+    }
+
+    const AdmissionController::Counters& after = api.getAdmission().getCounters();
+    report.admission.admitted = after.admitted - before.admitted;
+    report.admission.rateLimited = after.rateLimited - before.rateLimited;
+    report.admission.overloaded = after.overloaded - before.overloaded;
+    report.admission.lowMemory = after.lowMemory - before.lowMemory;
+    return report;
+}
+
+static unsigned long percentile(std::vector<unsigned long> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[(size_t)(p * (v.size() - 1))];
+}
+
+static void printReport(const CapacityOptions& opt, const CapacityReport& r) {
+    printf("=== ESP32APIServer capacity (real handlers, virtual clients) ===\n");
+    printf("Load: %d clients x %.2f req/s for %.0f s | mix %s\n",
+           opt.clients, opt.ratePerClient, opt.durationS, opt.mix.c_str());
+    printf("Model: heap at rest %ld B, %ld B/connection, snd buf %ld B, max TCP %d, "
+           "link %.0f kbps, RTT %.0f ms, CPU %.0f ms/request\n",
+           opt.heapAtRest, opt.connBytes, opt.sndBuf, opt.maxTcp, opt.linkKbps, opt.rttMs, opt.cpuMs);
+    printf("%-12s %7s %7s %6s %6s %6s %8s %8s %10s %10s %8s\n", "route", "reqs", "2xx/3xx", "429",
+           "503", "other", "refused", "body B", "retained B", "handler pk", "AsyncTCP");
+    uint64_t total = 0, refused = 0;
+    for (int i = 0; i < ROUTE_COUNT; i++) {
+        const RouteStats& s = r.routes[i];
+        if (s.requests == 0) continue;
+        uint64_t handled = s.requests - s.refused;
+        total += s.requests;
+        refused += s.refused;
+        printf("%-12s %7llu %7llu %6llu %6llu %6llu %8llu %8llu %10lld %10lld %6.1f ms\n", ROUTES[i].name,
+               (unsigned long long)s.requests, (unsigned long long)s.ok, (unsigned long long)s.rateLimited,
+               (unsigned long long)s.busy, (unsigned long long)s.other, (unsigned long long)s.refused,
+               (unsigned long long)(handled ? s.bodyBytes / handled : 0),
+               handled ? s.retainedBytes / (long long)handled : 0, s.peakBytes,
+               handled ? (double)s.handlerMs / handled : 0.0);
+    }
+    printf("Requests: %llu | admitted %u | 429 %u | 503 overloaded %u, low memory %u | refused by TCP %llu\n",
+           (unsigned long long)total, r.admission.admitted, r.admission.rateLimited, r.admission.overloaded,
+           r.admission.lowMemory, (unsigned long long)refused);
+    printf("Max open connections: %d | max in flight (admission): %d | AsyncTCP queue max %zu, "
+           "wait p50 %lu ms, p99 %lu ms\n",
+           r.maxOpen, r.maxInFlight, r.maxQueue, percentile(r.waitMs, 0.5), percentile(r.waitMs, 0.99));
+    printf("Free heap: min %ld B at t=%.1f s | below MEMORY_WARNING_THRESHOLD (%d B): ",
+           r.minHeap, r.minHeapAtMs / 1000.0, MEMORY_WARNING_THRESHOLD);
+    if (r.firstWarningMs < 0) {
+        printf("never\n");
+    } else {
+        printf("first at t=%.1f s, %.1f s in total\n", r.firstWarningMs / 1000.0, r.belowWarningMs / 1000.0);
+    }
+}
+
+int main(int argc, char** argv) {
+    CapacityOptions opt;
+    bool sweep = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--clients" && i + 1 < argc) opt.clients = atoi(argv[++i]);
+        else if (arg == "--rate" && i + 1 < argc) opt.ratePerClient = atof(argv[++i]);
+        else if (arg == "--duration" && i + 1 < argc) opt.durationS = atof(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) opt.seed = (unsigned)atoi(argv[++i]);
+        else if (arg == "--mix" && i + 1 < argc) opt.mix = argv[++i];
+        else if (arg == "--heap" && i + 1 < argc) opt.heapAtRest = atol(argv[++i]);
+        else if (arg == "--conn-bytes" && i + 1 < argc) opt.connBytes = atol(argv[++i]);
+        else if (arg == "--snd-buf" && i + 1 < argc) opt.sndBuf = atol(argv[++i]);
+        else if (arg == "--max-tcp" && i + 1 < argc) opt.maxTcp = atoi(argv[++i]);
+        else if (arg == "--link-kbps" && i + 1 < argc) opt.linkKbps = atof(argv[++i]);
+        else if (arg == "--rtt-ms" && i + 1 < argc) opt.rttMs = atof(argv[++i]);
+        else if (arg == "--cpu-ms" && i + 1 < argc) opt.cpuMs = atof(argv[++i]);
+        else if (arg == "--block-overhead" && i + 1 < argc) blockOverhead = (size_t)atol(argv[++i]);
+        else if (arg == "--sweep") sweep = true;
+        else if (arg == "--verbose") Serial.quiet = false;
+        else {
+            fprintf(stderr, "Usage: %s [--clients N] [--rate req/s] [--duration s] [--seed N] [--mix a=w,b=w]\n"
+                            "          [--heap B] [--conn-bytes B] [--snd-buf B] [--max-tcp N]\n"
+                            "          [--link-kbps K] [--rtt-ms ms] [--cpu-ms ms] [--block-overhead B] [--sweep]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<double> weights;
+    if (!parseMix(opt.mix, weights) || opt.clients <= 0 || opt.ratePerClient <= 0 || opt.linkKbps <= 0) {
+        return 2;
+    }
+
+    HostArduino::setMillis(100000);
+    DeadlineMonitor::init();
+    sensor.init();
+    servo.init();
+    pool.addCamera("front", &front);
+    pool.addCamera("rear", &rear);
+    if (!api.init(&sensor, &servo, &pool, &state, &history)) {
+        fprintf(stderr, "api.init() failed\n");
+        return 1;
+    }
+    api.begin();
+    warmUp();
+
+    if (!sweep) {
+        printReport(opt, simulate(opt, weights));
+        return 0;
+    }
+
+    printf("=== ESP32APIServer capacity sweep: %.2f req/s per client, %.0f s, mix %s ===\n",
+           opt.ratePerClient, opt.durationS, opt.mix.c_str());
+    printf("%7s %8s %8s %6s %6s %8s %8s %10s %12s\n", "clients", "offered", "2xx/3xx", "429", "503",
+           "refused", "wait p99", "min heap", "< warning");
+    static const int loads[] = { 1, 2, 4, 8, 12, 16, 24, 32, 48, 64 };
+    for (int clients : loads) {
+        CapacityOptions run = opt;
+        run.clients = clients;
+        // Chaque charge repart d'un serveur au repos : clients oubliés, buckets pleins
+        HostArduino::setMillis(millis() + 60000);
+        CapacityReport r = simulate(run, weights);
+        uint64_t total = 0, ok = 0, refused = 0;
+        for (const RouteStats& s : r.routes) {
+            total += s.requests;
+            ok += s.ok;
+            refused += s.refused;
+        }
+        char warning[32];
+        if (r.firstWarningMs < 0) snprintf(warning, sizeof(warning), "never");
+        else snprintf(warning, sizeof(warning), "%.1f s", r.belowWarningMs / 1000.0);
+        printf("%7d %8llu %7.1f%% %6u %6u %8llu %5lu ms %8ld B %12s\n", clients, (unsigned long long)total,
+               total ? 100.0 * ok / total : 0.0, r.admission.rateLimited,
+               r.admission.overloaded + r.admission.lowMemory, (unsigned long long)refused,
+               percentile(r.waitMs, 0.99), r.minHeap, warning);
+    }
+    return 0;
+}
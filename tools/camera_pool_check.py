@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Vérifie la capture parallèle du CameraPool contre plusieurs mocks ESP32-CAM.
+
+Lance un tools/mock_esp32cam.py par latence demandée (ports consécutifs),
+puis, si --target est fourni, déclenche des rondes POST /api/capture sur
+l'ESP32 et compare la latence totale à celle de la caméra la plus lente
+(attendu en parallèle) et à la somme (ce que donnerait un enchaînement).
+
+Le fan-out lui-même est testé sur l'hôte, sans carte, par
+test/test_camera_pool ; ce script valide le firmware flashé sur le vrai
+réseau.
+
+Les caméras du firmware doivent pointer vers ces mocks, par exemple :
+  #define ESP32CAM_IP "192.168.1.20:8081"
+  #define ESP32CAM_REAR_IP "192.168.1.20:8082"
+
+Usage:
+  python3 tools/camera_pool_check.py --latencies 0.4,1.2 --target 192.168.1.42 --rounds 5
+"""
+
+import argparse
+import http.client
+import json
+import os
+import subprocess
+import sys
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def request(host, port, method, path, timeout=10.0):
+    conn = http.client.HTTPConnection(host, port, timeout=timeout)
+    conn.request(method, path)
+    resp = conn.getresponse()
+    body = resp.read()
+    conn.close()
+    return resp.status, (json.loads(body) if body else {})
+
+
+def run_round(host, port, poll_timeout):
+    status, body = request(host, port, "POST", "/api/capture")
+    if status != 202:
+        return None, f"HTTP {status}: {body}"
+    round_id = body["round"]
+    deadline = time.monotonic() + poll_timeout
+    while time.monotonic() < deadline:
+        time.sleep(0.1)
+        status, info = request(host, port, "GET", "/api/capture")
+        if status == 200 and info.get("round") == round_id and not info.get("in_progress"):
+            return info, None
+    return None, "round did not complete in time"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Test du pool de caméras contre des mocks")
+    parser.add_argument("--latencies", default="0.3,0.9",
+                        help="Latence de chaque mock caméra en secondes, séparées par des virgules")
+    parser.add_argument("--base-port", type=int, default=8081)
+    parser.add_argument("--target", help="IP[:port] de l'ESP32 (sans cible: mocks seuls)")
+    parser.add_argument("--rounds", type=int, default=5)
+    parser.add_argument("--interval", type=float, default=3.5,
+                        help="Pause entre rondes (requestPhoto refuse < 3 s)")
+    args = parser.parse_args()
+
+    latencies = [float(x) for x in args.latencies.split(",")]
+    mocks = []
+    for i, latency in enumerate(latencies):
+        port = args.base_port + i
+        mocks.append(subprocess.Popen([sys.executable, os.path.join(HERE, "mock_esp32cam.py"),
+                                       "--port", str(port), "--latency", str(latency),
+                                       "--jitter", "0"]))
+        print(f"📷 Mock camera {i} on port {port} (latency {latency * 1000:.0f} ms)")
+
+    try:
+        if not args.target:
+            print("No --target given: mocks running, Ctrl+C to stop")
+            while True:
+                time.sleep(1)
+
+        host, _, port = args.target.partition(":")
+        port = int(port or 80)
+        time.sleep(1.0)
+
+        slowest_ms = max(latencies) * 1000
+        sum_ms = sum(latencies) * 1000
+        totals = []
+        for n in range(args.rounds):
+            info, error = run_round(host, port, poll_timeout=10.0)
+            if error:
+                print(f"Round {n + 1}: ❌ {error}")
+            else:
+                totals.append(info["latency_ms"])
+                per_cam = ", ".join(f"{r['name']}={r['latency_ms']} ms{'' if r['success'] else ' ✗'}"
+                                    for r in info["results"])
+                print(f"Round {info['round']}: total {info['latency_ms']} ms "
+                      f"({info['succeeded']}/{info['cameras']} ok) | {per_cam}")
+            time.sleep(args.interval)
+
+        if totals:
+            # En parallèle, chaque ronde dure celle de la caméra la plus lente plus
+            # la latence réseau : la marge ne couvre pas une caméra supplémentaire
+            margin_ms = max(150.0, 0.15 * slowest_ms)
+            worst = max(totals)
+            avg = sum(totals) / len(totals)
+            parallel = worst <= slowest_ms + margin_ms
+            verdict = "✅ parallel" if parallel else "❌ looks sequential"
+            print(f"\nAverage total: {avg:.0f} ms | worst: {worst} ms | slowest camera: {slowest_ms:.0f} ms "
+                  f"(+{margin_ms:.0f} ms allowed) | sum: {sum_ms:.0f} ms -> {verdict}")
+            if not parallel:
+                sys.exit(1)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        for mock in mocks:
+            mock.terminate()
+
+
+if __name__ == "__main__":
+    main()
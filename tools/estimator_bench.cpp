@@ -0,0 +1,110 @@
+// Benchmark hôte de ApproachEstimator : coût par échantillon et erreur de
+// prédiction du temps d'arrivée sur des approches simulées (vitesse
+// constante, bruit gaussien, échos aberrants).
+//
+// Compilation :
+//   g++ -O2 -std=c++17 -Itools/host -Iinclude tools/host/HostArduino.cpp
+//       src/ApproachEstimator.cpp tools/estimator_bench.cpp -o estimator_bench
+
+#include "Arduino.h"
+#include "ESP32Config.h"
+#include "ApproachEstimator.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+static float lastCallbackEta = -1;
+static void onApproach(float etaMs, float, float) {
+    lastCallbackEta = etaMs;
+}
+
+struct ScenarioResult {
+    std::vector<float> etaErrorsMs;     // |ETA prédit - ETA réel| quand l'ETA réel < 3 s
+    int callbacks = 0;
+    int lateCallbacks = 0;              // Moins de 500 ms de marge réelle, ou après l'arrivée
+    int missedCallbacks = 0;            // Aucun callback, même après l'arrivée
+};
+
+static void runScenario(float speedCmS, unsigned long periodMs, int runs, std::mt19937& rng,
+                        ScenarioResult& result) {
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const float threshold = DETECTION_DISTANCE_CM;
+    const float startCm = 380.0f;
+
+    for (int run = 0; run < runs; run++) {
+        ApproachEstimator estimator;
+        estimator.setApproachCallback(onApproach, threshold, APPROACH_LEAD_MS);
+        lastCallbackEta = -1;
+        bool fired = false;
+
+        unsigned long t = (unsigned long)(unit(rng) * periodMs) + 1000;
+        unsigned long arrival = t + (unsigned long)((startCm - threshold) / speedCmS * 1000.0f);
+
+        for (; t < arrival + periodMs; t += periodMs) {
+            float trueCm = startCm - speedCmS * (t - (arrival - (startCm - threshold) / speedCmS * 1000.0f)) / 1000.0f;
+            float measured = unit(rng) < 0.02f ? 399.0f : trueCm + noise(rng);
+            estimator.update(measured, t);
+
+            if (!fired && lastCallbackEta >= 0) {
+                fired = true;
+                result.callbacks++;
+                if (arrival < t + 500) {
+                    result.lateCallbacks++;
+                }
+            }
+
+            float trueEta = (float)arrival - (float)t;
+            float eta = estimator.getTimeToThresholdMs(threshold);
+            if (trueEta > 0 && trueEta < 3000 && eta >= 0) {
+                result.etaErrorsMs.push_back(fabsf(eta - trueEta));
+            }
+        }
+        if (!fired) {
+            result.missedCallbacks++;
+        }
+    }
+}
+
+static float percentile(std::vector<float> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[(size_t)(p * (v.size() - 1))];
+}
+
+int main() {
+    std::mt19937 rng(42);
+
+    // Coût par échantillon
+    {
+        ApproachEstimator estimator;
+        const int n = 10000000;
+        volatile float sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < n; i++) {
+            estimator.update(300.0f - (i % 600) * 0.5f, 1000 + i * 100UL);
+            sink = estimator.getTimeToThresholdMs(DETECTION_DISTANCE_CM);
+        }
+        double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / n;
+        (void)sink;
+        printf("Cost: %.1f ns per sample (update + ETA) on host\n\n", ns);
+    }
+
+    printf("%-10s %-8s %10s %10s %10s %8s %8s\n",
+           "speed", "period", "ETA p50", "ETA p90", "samples", "late", "missed");
+    const float speeds[] = { 20, 50, 100, 200 };
+    const unsigned long periods[] = { 500, 200, 100 };
+    for (unsigned long period : periods) {
+        for (float speed : speeds) {
+            ScenarioResult r;
+            runScenario(speed, period, 200, rng, r);
+            printf("%-7.0fcm/s %-5lums %8.0f ms %8.0f ms %10zu %7d%% %7d%%\n",
+                   speed, period, percentile(r.etaErrorsMs, 0.5), percentile(r.etaErrorsMs, 0.9),
+                   r.etaErrorsMs.size(), r.lateCallbacks * 100 / 200, r.missedCallbacks * 100 / 200);
+        }
+    }
+    printf("\nlate = callback fired < 500 ms before arrival or after it; missed = no callback at all\n");
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Couche Arduino minimale pour compiler la logique du firmware sur l'hôte
+// (rejeu de traces, benchmarks). Horloge et capteur sont virtuels : le
+// temps n'avance que via HostArduino::setMillis() et delay(), pulseIn()
+// renvoie la prochaine durée fournie par HostArduino::setNextPulse().
+// HostArduino::useRealClock() bascule sur l'horloge réelle (delay() dort
+// vraiment) pour les tests multi-tâches (tools/host/freertos). ESP renvoie
+// un heap réglé par HostArduino::setFreeHeap(). Les serveurs web, WiFi,
+// LittleFS et ArduinoJson ont leurs propres en-têtes (HostWeb.cpp).
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+using std::min;
+using std::max;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+long pulseIn(int pin, int state, unsigned long timeoutUs);
+
+class HostSerial {
+public:
+    bool quiet = true;
+    void begin(unsigned long) {}
+    void print(const char* s) { if (!quiet) fputs(s, stdout); }
+    void println(const char* s = "") { if (!quiet) puts(s); }
+    int printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        if (quiet) return 0;
+        va_list args;
+        va_start(args, fmt);
+        int n = vprintf(fmt, args);
+        va_end(args);
+        return n;
+    }
+};
+extern HostSerial Serial;
+
+// Sous-ensemble de String utilisé par le firmware (construction d'URL, logs,
+// paramètres et corps des réponses HTTP)
+class String {
+private:
+    std::string s;
+
+public:
+    String() {}
+    String(const char* str) : s(str ? str : "") {}
+    String(const std::string& str) : s(str) {}
+    String(unsigned long n) : s(std::to_string(n)) {}
+    String(long n) : s(std::to_string(n)) {}
+    String(int n) : s(std::to_string(n)) {}
+    const char* c_str() const { return s.c_str(); }
+    size_t length() const { return s.length(); }
+    bool reserve(size_t size) { s.reserve(size); return true; }
+    long toInt() const { return atol(s.c_str()); }
+    bool operator==(const String& o) const { return s == o.s; }
+    bool operator!=(const String& o) const { return s != o.s; }
+    String& operator+=(const String& o) { s += o.s; return *this; }
+    friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a) + b.s); }
+};
+
+// Sections critiques FreeRTOS : verrou tournant réel, les tests du pool de
+// caméras exécutent les tâches dans des threads
+struct portMUX_TYPE {
+    std::atomic<bool> locked;
+    portMUX_TYPE(int = 0) : locked(false) {}
+    portMUX_TYPE& operator=(int) { locked = false; return *this; }
+};
+#define portMUX_INITIALIZER_UNLOCKED 0
+inline void hostEnterCritical(portMUX_TYPE* mux) {
+    while (mux->locked.exchange(true, std::memory_order_acquire)) {}
+}
+inline void hostExitCritical(portMUX_TYPE* mux) {
+    mux->locked.store(false, std::memory_order_release);
+}
+#define portENTER_CRITICAL(mux) hostEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) hostExitCritical(mux)
+
+// Sous-ensemble de EspClass lu par DebugHelper et l'admission
+class HostEsp {
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    const char* getChipModel() { return "host"; }
+    uint8_t getChipRevision() { return 0; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+    uint32_t getPsramSize() { return 0; }
+    const char* getSdkVersion() { return "host"; }
+};
+extern HostEsp ESP;
+
+namespace HostArduino {
+    void setMillis(unsigned long ms);
+    void setNextPulse(long durationUs);
+    // Horloge réelle (millis() = temps écoulé + décalage réglé par setMillis())
+    void useRealClock(bool real);
+    void setFreeHeap(uint32_t bytes);
+}
+
+#endif
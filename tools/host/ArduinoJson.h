@@ -0,0 +1,322 @@
+// Sous-ensemble d'ArduinoJson 7 utilisé par ESP32APIServer (objets, tableaux
+// imbriqués, serializeJson vers String).
+//
+// Les allocations suivent le modèle d'ArduinoJson 7 sur ESP32 pour que les
+// outils hôte mesurent ce que les handlers demandent réellement au heap :
+// - StaticJsonDocument<N> n'est qu'un alias déprécié de JsonDocument, la
+//   capacité N est ignorée et tout est alloué sur le heap ;
+// - les slots (16 octets, 2 par membre d'objet) sont pris dans des pools de
+//   HOST_JSON_POOL_SLOTS alloués à la demande ;
+// - les littéraux sont liés, les const char* et String sont copiés dans un
+//   nœud de chaîne (en-tête + texte + '\0').
+// Les valeurs elles-mêmes sont stockées dans un tableau interne au document
+// (sur la pile, hors comptage) ; seules les allocations modélisées passent
+// par operator new.
+#ifndef HOST_ARDUINO_JSON_H
+#define HOST_ARDUINO_JSON_H
+
+#include "Arduino.h"
+#include <cmath>
+#include <type_traits>
+
+#define HOST_JSON_SLOT_BYTES 16         // VariantData avec double et long long (ESP32)
+#define HOST_JSON_POOL_SLOTS 128        // ARDUINOJSON_POOL_CAPACITY (SLOT_ID_SIZE 2)
+#define HOST_JSON_STRING_HEADER 8       // StringNode : next + compteur de références + longueur
+#define HOST_JSON_MAX_NODES 96          // Limite du tableau interne du shim (pas du modèle)
+#define HOST_JSON_TEXT_BYTES 1024
+
+class JsonDocument;
+
+namespace HostJson {
+    // Documents dont le tableau interne a débordé (doit rester à 0)
+    extern uint32_t internalOverflows;
+}
+
+class JsonVariantRef {
+protected:
+    JsonDocument* doc;
+    int node;
+
+public:
+    JsonVariantRef(JsonDocument* d = nullptr, int n = -1) : doc(d), node(n) {}
+    bool isNull() const { return doc == nullptr || node < 0; }
+};
+
+class JsonObject;
+
+class JsonArray : public JsonVariantRef {
+public:
+    using JsonVariantRef::JsonVariantRef;
+    JsonObject createNestedObject();
+};
+
+// Membre d'objet en cours d'affectation : doc["clé"] = valeur
+class JsonMemberProxy {
+private:
+    JsonDocument* doc;
+    int object;
+    const char* key;
+
+    int member();
+
+public:
+    JsonMemberProxy(JsonDocument* d, int o, const char* k) : doc(d), object(o), key(k) {}
+
+    // Littéral : stocké par pointeur (surcharge plus spécialisée que const char*)
+    template <size_t N>
+    JsonMemberProxy& operator=(const char (&value)[N]);
+    template <typename T>
+    typename std::enable_if<std::is_same<T, const char*>::value || std::is_same<T, char*>::value,
+                            JsonMemberProxy&>::type operator=(T value);
+    JsonMemberProxy& operator=(const String& value);
+    template <typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value, JsonMemberProxy&>::type operator=(T value);
+};
+
+class JsonObject : public JsonVariantRef {
+public:
+    using JsonVariantRef::JsonVariantRef;
+    JsonMemberProxy operator[](const char* key) { return JsonMemberProxy(doc, node, key); }
+};
+
+class JsonDocument {
+    friend class JsonMemberProxy;
+    friend class JsonArray;
+    friend size_t serializeJson(const JsonDocument& doc, String& output);
+
+    enum Type : uint8_t { T_NULL, T_BOOL, T_INT, T_UINT, T_FLOAT, T_STRING, T_ARRAY, T_OBJECT };
+
+    struct Node {
+        Type type;
+        const char* key;
+        union {
+            bool b;
+            long long i;
+            unsigned long long u;
+            double f;
+            const char* s;
+        };
+        int first, last, next;
+    };
+
+    Node nodes[HOST_JSON_MAX_NODES];
+    char text[HOST_JSON_TEXT_BYTES];
+    int nodeCount;
+    size_t textUsed;
+    // Allocations modélisées (comptées par les hooks d'operator new des outils)
+    char* pools[8];
+    uint8_t poolCount;
+    size_t slotsUsed;
+    char* strings[HOST_JSON_MAX_NODES];
+    int stringCount;
+    size_t modeledBytes;
+    bool overflow;
+
+    bool allocSlots(size_t count) {
+        slotsUsed += count;
+        while (slotsUsed > poolCount * (size_t)HOST_JSON_POOL_SLOTS) {
+            if (poolCount == sizeof(pools) / sizeof(pools[0])) {
+                overflow = true;
+                return false;
+            }
+            pools[poolCount++] = new char[HOST_JSON_POOL_SLOTS * HOST_JSON_SLOT_BYTES];
+            modeledBytes += HOST_JSON_POOL_SLOTS * HOST_JSON_SLOT_BYTES;
+        }
+        return true;
+    }
+
+    int addNode(int parent, const char* key) {
+        // Membre d'objet = slot clé + slot valeur, élément de tableau = 1 slot
+        if (nodeCount == HOST_JSON_MAX_NODES || !allocSlots(key ? 2 : 1)) {
+            if (nodeCount == HOST_JSON_MAX_NODES) {
+                HostJson::internalOverflows++;
+            }
+            overflow = true;
+            return -1;
+        }
+        int id = nodeCount++;
+        Node& n = nodes[id];
+        n.type = T_NULL;
+        n.key = key;
+        n.u = 0;
+        n.first = n.last = n.next = -1;
+        if (parent >= 0) {
+            if (nodes[parent].last >= 0) {
+                nodes[nodes[parent].last].next = id;
+            } else {
+                nodes[parent].first = id;
+            }
+            nodes[parent].last = id;
+        }
+        return id;
+    }
+
+    const char* copyString(const char* value) {
+        size_t len = strlen(value);
+        if (textUsed + len + 1 > sizeof(text) || stringCount == HOST_JSON_MAX_NODES) {
+            HostJson::internalOverflows++;
+            overflow = true;
+            return "";
+        }
+        strings[stringCount++] = new char[HOST_JSON_STRING_HEADER + len + 1];
+        modeledBytes += HOST_JSON_STRING_HEADER + len + 1;
+        char* copy = text + textUsed;
+        memcpy(copy, value, len + 1);
+        textUsed += len + 1;
+        return copy;
+    }
+
+    static void writeString(std::string& out, const char* s) {
+        out += '"';
+        for (; *s; s++) {
+            if (*s == '"' || *s == '\\') {
+                out += '\\';
+                out += *s;
+            } else if ((unsigned char)*s < 0x20) {
+                char esc[8];
+                snprintf(esc, sizeof(esc), "\\u%04x", *s);
+                out += esc;
+            } else {
+                out += *s;
+            }
+        }
+        out += '"';
+    }
+
+    void write(std::string& out, int id) const {
+        const Node& n = nodes[id];
+        char buf[32];
+        switch (n.type) {
+            case T_NULL: out += "null"; break;
+            case T_BOOL: out += n.b ? "true" : "false"; break;
+            case T_INT: snprintf(buf, sizeof(buf), "%lld", n.i); out += buf; break;
+            case T_UINT: snprintf(buf, sizeof(buf), "%llu", n.u); out += buf; break;
+            case T_FLOAT:
+                if (std::isnan(n.f) || std::isinf(n.f)) {
+                    out += "null";
+                } else {
+                    snprintf(buf, sizeof(buf), "%.9g", n.f);
+                    out += buf;
+                }
+                break;
+            case T_STRING: writeString(out, n.s); break;
+            case T_ARRAY:
+            case T_OBJECT:
+                out += n.type == T_ARRAY ? '[' : '{';
+                for (int c = n.first; c >= 0; c = nodes[c].next) {
+                    if (c != n.first) out += ',';
+                    if (n.type == T_OBJECT) {
+                        writeString(out, nodes[c].key);
+                        out += ':';
+                    }
+                    write(out, c);
+                }
+                out += n.type == T_ARRAY ? ']' : '}';
+                break;
+        }
+    }
+
+public:
+    JsonDocument() : nodeCount(0), textUsed(0), poolCount(0), slotsUsed(0), stringCount(0),
+                     modeledBytes(0), overflow(false) {
+        // Racine : objet, sans slot (stockée dans le document)
+        Node& root = nodes[nodeCount++];
+        root.type = T_OBJECT;
+        root.key = nullptr;
+        root.first = root.last = root.next = -1;
+    }
+    ~JsonDocument() {
+        for (uint8_t i = 0; i < poolCount; i++) delete[] pools[i];
+        for (int i = 0; i < stringCount; i++) delete[] strings[i];
+    }
+    JsonDocument(const JsonDocument&) = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+
+    JsonMemberProxy operator[](const char* key) { return JsonMemberProxy(this, 0, key); }
+
+    JsonArray createNestedArray(const char* key) {
+        int id = addNode(0, key);
+        if (id >= 0) nodes[id].type = T_ARRAY;
+        return JsonArray(this, id);
+    }
+
+    bool overflowed() const { return overflow; }
+    // Octets demandés au heap par le modèle (pools + nœuds de chaînes)
+    size_t memoryUsage() const { return modeledBytes; }
+};
+
+// Alias déprécié d'ArduinoJson 7 : la capacité est ignorée
+template <size_t N>
+class StaticJsonDocument : public JsonDocument {};
+
+inline JsonObject JsonArray::createNestedObject() {
+    if (isNull()) return JsonObject();
+    int id = doc->addNode(node, nullptr);
+    if (id >= 0) doc->nodes[id].type = JsonDocument::T_OBJECT;
+    return JsonObject(doc, id);
+}
+
+inline int JsonMemberProxy::member() {
+    if (doc == nullptr || object < 0) return -1;
+    for (int c = doc->nodes[object].first; c >= 0; c = doc->nodes[c].next) {
+        if (strcmp(doc->nodes[c].key, key) == 0) return c;
+    }
+    return doc->addNode(object, key);
+}
+
+template <size_t N>
+JsonMemberProxy& JsonMemberProxy::operator=(const char (&value)[N]) {
+    int id = member();
+    if (id >= 0) {
+        doc->nodes[id].type = JsonDocument::T_STRING;
+        doc->nodes[id].s = value;
+    }
+    return *this;
+}
+
+template <typename T>
+typename std::enable_if<std::is_same<T, const char*>::value || std::is_same<T, char*>::value,
+                        JsonMemberProxy&>::type
+JsonMemberProxy::operator=(T value) {
+    int id = member();
+    if (id >= 0) {
+        doc->nodes[id].type = value ? JsonDocument::T_STRING : JsonDocument::T_NULL;
+        if (value) doc->nodes[id].s = doc->copyString(value);
+    }
+    return *this;
+}
+
+inline JsonMemberProxy& JsonMemberProxy::operator=(const String& value) {
+    return *this = (const char*)value.c_str();
+}
+
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value, JsonMemberProxy&>::type
+JsonMemberProxy::operator=(T value) {
+    int id = member();
+    if (id < 0) return *this;
+    JsonDocument::Node& n = doc->nodes[id];
+    if (std::is_same<T, bool>::value) {
+        n.type = JsonDocument::T_BOOL;
+        n.b = value;
+    } else if (std::is_floating_point<T>::value) {
+        n.type = JsonDocument::T_FLOAT;
+        n.f = (double)value;
+    } else if (std::is_signed<T>::value) {
+        n.type = JsonDocument::T_INT;
+        n.i = (long long)value;
+    } else {
+        n.type = JsonDocument::T_UINT;
+        n.u = (unsigned long long)value;
+    }
+    return *this;
+}
+
+inline size_t serializeJson(const JsonDocument& doc, String& output) {
+    std::string out;
+    doc.write(out, 0);
+    output = String(out);
+    return out.size();
+}
+
+#endif
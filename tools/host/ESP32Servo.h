@@ -0,0 +1,21 @@
+// Servo pour l'hôte : garde seulement le dernier angle écrit
+#ifndef HOST_ESP32_SERVO_H
+#define HOST_ESP32_SERVO_H
+
+class ESP32PWM {
+public:
+    static void allocateTimer(int) {}
+};
+
+class Servo {
+private:
+    int angle = -1;
+
+public:
+    void setPeriodHertz(int) {}
+    int attach(int, int, int) { return 1; }
+    void write(int value) { angle = value; }
+    int read() const { return angle; }
+};
+
+#endif
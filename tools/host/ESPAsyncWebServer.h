@@ -0,0 +1,172 @@
+// ESPAsyncWebServer hôte : mêmes classes et signatures que la bibliothèque
+// pour compiler ESP32APIServer tel quel. Pas de socket : les outils créent
+// une AsyncWebServerRequest, la passent à AsyncWebServer::hostHandle() (comme
+// la tâche AsyncTCP) puis ferment la connexion avec hostDisconnect().
+// Comme dans la bibliothèque, la requête possède sa réponse (allouée sur le
+// heap) jusqu'à sa destruction ; les réponses à remplissage (callback,
+// fichier) ne gardent pas de corps en mémoire.
+#ifndef HOST_ESP_ASYNC_WEB_SERVER_H
+#define HOST_ESP_ASYNC_WEB_SERVER_H
+
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "LittleFS.h"
+#include <functional>
+#include <vector>
+
+typedef enum {
+    HTTP_GET = 0b00000001,
+    HTTP_POST = 0b00000010,
+    HTTP_ANY = 0b01111111
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest;
+typedef std::function<void(AsyncWebServerRequest*)> ArRequestHandlerFunction;
+typedef std::function<size_t(uint8_t*, size_t, size_t)> AwsResponseFiller;
+typedef std::function<void()> ArDisconnectHandler;
+
+class AsyncWebParameter {
+private:
+    String name;
+    String val;
+
+public:
+    AsyncWebParameter(const String& n, const String& v) : name(n), val(v) {}
+    const String& getName() const { return name; }
+    const String& value() const { return val; }
+};
+
+class AsyncClient {
+private:
+    IPAddress ip;
+
+public:
+    explicit AsyncClient(IPAddress addr) : ip(addr) {}
+    IPAddress remoteIP() const { return ip; }
+};
+
+class AsyncWebServerResponse {
+protected:
+    int code;
+    String contentType;
+    std::vector<std::pair<String, String>> headers;
+    size_t contentLength;
+
+public:
+    AsyncWebServerResponse(int c, const String& type, size_t length)
+        : code(c), contentType(type), contentLength(length) {}
+    virtual ~AsyncWebServerResponse() {}
+    void addHeader(const String& name, const String& value) { headers.push_back({ name, value }); }
+
+    int hostCode() const { return code; }
+    const char* hostHeader(const char* name) const;
+    virtual size_t hostLength() const { return contentLength; }
+    // Produit le corps par morceaux comme lors de l'envoi TCP
+    virtual String hostBody() { return String(); }
+};
+
+class AsyncBasicResponse : public AsyncWebServerResponse {
+private:
+    String content;
+
+public:
+    AsyncBasicResponse(int c, const String& type = String(), const String& body = String())
+        : AsyncWebServerResponse(c, type, body.length()), content(body) {}
+    String hostBody() override { return content; }
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse {
+private:
+    std::string content;
+
+public:
+    // La bibliothèque réserve un cbuf de 1460 octets qui grandit à l'écriture
+    AsyncResponseStream(const String& type, size_t bufferSize)
+        : AsyncWebServerResponse(200, type, 0) { content.reserve(bufferSize); }
+    size_t print(const char* s) { content += s; return strlen(s); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    size_t hostLength() const override { return content.size(); }
+    String hostBody() override { return String(content); }
+};
+
+class AsyncCallbackResponse : public AsyncWebServerResponse {
+private:
+    AwsResponseFiller filler;
+
+public:
+    AsyncCallbackResponse(const String& type, size_t length, AwsResponseFiller callback)
+        : AsyncWebServerResponse(200, type, length), filler(callback) {}
+    String hostBody() override;
+};
+
+class AsyncFileResponse : public AsyncWebServerResponse {
+private:
+    std::string path;
+
+public:
+    AsyncFileResponse(const std::string& hostPath, const String& type, size_t length)
+        : AsyncWebServerResponse(200, type, length), path(hostPath) {}
+    String hostBody() override;
+};
+
+class AsyncWebServerRequest {
+private:
+    WebRequestMethodComposite httpMethod;
+    String path;
+    std::vector<AsyncWebParameter> params;
+    AsyncClient tcpClient;
+    AsyncWebServerResponse* response;
+    ArDisconnectHandler disconnectHandler;
+
+public:
+    // url avec chaîne de requête : "/api/history?metric=distance&points=50"
+    AsyncWebServerRequest(WebRequestMethodComposite method, const char* url, IPAddress remote);
+    ~AsyncWebServerRequest();
+
+    WebRequestMethodComposite method() const { return httpMethod; }
+    const String& url() const { return path; }
+    AsyncClient* client() { return &tcpClient; }
+    bool hasParam(const char* name) const;
+    const AsyncWebParameter* getParam(const char* name) const;
+    // Un seul callback, remplacé à chaque appel (comme la bibliothèque)
+    void onDisconnect(ArDisconnectHandler fn) { disconnectHandler = fn; }
+
+    AsyncWebServerResponse* beginResponse(int code, const String& contentType = String(),
+                                          const String& content = String());
+    AsyncWebServerResponse* beginResponse(const String& contentType, size_t len, AwsResponseFiller callback);
+    AsyncResponseStream* beginResponseStream(const String& contentType, size_t bufferSize = 1460);
+    void send(AsyncWebServerResponse* resp);
+    void send(int code, const String& contentType = String(), const String& content = String());
+    void send(FS& fs, const String& path, const String& contentType = String(), bool download = false);
+
+    // Côté outils hôte
+    AsyncWebServerResponse* hostResponse() { return response; }
+    // Fin de la connexion TCP : appelle le callback de déconnexion
+    void hostDisconnect();
+};
+
+class AsyncWebServer {
+private:
+    struct Route {
+        String uri;
+        WebRequestMethodComposite method;
+        ArRequestHandlerFunction handler;
+    };
+    std::vector<Route> routes;
+    ArRequestHandlerFunction notFound;
+    static AsyncWebServer* last;
+
+public:
+    explicit AsyncWebServer(uint16_t port);
+    void on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest);
+    void onNotFound(ArRequestHandlerFunction fn) { notFound = fn; }
+    void begin() {}
+
+    // Dernier serveur construit (ESP32APIServer garde le sien en membre privé)
+    static AsyncWebServer* hostInstance() { return last; }
+    // Même sélection que la bibliothèque : méthode, URI exacte ou préfixe "uri/"
+    void hostHandle(AsyncWebServerRequest* request);
+};
+
+#endif
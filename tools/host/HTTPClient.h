@@ -0,0 +1,39 @@
+// HTTPClient simulé pour l'hôte : chaque hôte enregistré via HostHTTP a une
+// durée de connexion, une durée de réponse et un code HTTP. Comme le vrai
+// HTTPClient ESP32, setConnectTimeout() borne la connexion et setTimeout()
+// borne l'attente de la réponse, séparément : le pire cas est leur somme.
+// Les durées s'écoulent avec delay() (horloge virtuelle ou réelle).
+#ifndef HOST_HTTP_CLIENT_H
+#define HOST_HTTP_CLIENT_H
+
+#include "Arduino.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+namespace HostHTTP {
+    // connectMs / responseMs < 0 : la phase ne se termine jamais (timeout)
+    void setEndpoint(const char* host, long connectMs, long responseMs, int code);
+    void removeEndpoint(const char* host);
+    unsigned long getRequestCount(const char* host);
+}
+
+class HTTPClient {
+private:
+    std::string host;
+    int32_t connectTimeoutMs = 5000;
+    uint32_t timeoutMs = 5000;
+    int perform();
+
+public:
+    bool begin(const String& url);
+    void end() {}
+    void setConnectTimeout(int32_t ms) { connectTimeoutMs = ms; }
+    void setTimeout(uint32_t ms) { timeoutMs = ms; }
+    void addHeader(const String&, const String&) {}
+    int GET() { return perform(); }
+    int POST(const String&) { return perform(); }
+    String getString() { return String("{\"status\":\"ok\"}"); }
+};
+
+#endif
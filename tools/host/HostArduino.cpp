@@ -0,0 +1,67 @@
+#include "Arduino.h"
+
+#include <chrono>
+#include <thread>
+
+HostSerial Serial;
+HostEsp ESP;
+
+static std::atomic<unsigned long> virtualMillis(0);
+static std::atomic<long> realOffsetMs(0);
+static bool realClock = false;
+static long nextPulse = 0;
+static std::atomic<uint32_t> freeHeap(200000);
+static std::atomic<uint32_t> minFreeHeap(200000);
+
+static long realElapsedMs() {
+    static const auto origin = std::chrono::steady_clock::now();
+    return (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - origin).count();
+}
+
+unsigned long millis() {
+    return realClock ? (unsigned long)(realElapsedMs() + realOffsetMs) : virtualMillis.load();
+}
+unsigned long micros() { return millis() * 1000UL; }
+
+void delay(unsigned long ms) {
+    if (realClock) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    } else {
+        virtualMillis += ms;
+    }
+}
+
+void delayMicroseconds(unsigned int) {}
+void yield() {}
+void pinMode(int, int) {}
+void digitalWrite(int, int) {}
+
+long pulseIn(int, int, unsigned long timeoutUs) {
+    return (nextPulse < 0 || (unsigned long)nextPulse > timeoutUs) ? 0 : nextPulse;
+}
+
+uint32_t HostEsp::getFreeHeap() { return freeHeap; }
+uint32_t HostEsp::getMinFreeHeap() { return minFreeHeap; }
+
+namespace HostArduino {
+    void setMillis(unsigned long ms) {
+        if (realClock) {
+            realOffsetMs = (long)ms - realElapsedMs();
+        } else {
+            virtualMillis = ms;
+        }
+    }
+    void setNextPulse(long durationUs) { nextPulse = durationUs; }
+    void useRealClock(bool real) {
+        unsigned long now = millis();
+        realClock = real;
+        setMillis(now);
+    }
+    void setFreeHeap(uint32_t bytes) {
+        freeHeap = bytes;
+        if (bytes < minFreeHeap) {
+            minFreeHeap = bytes;
+        }
+    }
+}
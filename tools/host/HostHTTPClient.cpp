@@ -0,0 +1,68 @@
+#include "HTTPClient.h"
+
+#include <map>
+#include <mutex>
+
+struct Endpoint {
+    long connectMs;
+    long responseMs;
+    int code;
+    unsigned long requests;
+};
+
+static std::mutex registryMutex;
+static std::map<std::string, Endpoint> registry;
+
+namespace HostHTTP {
+    void setEndpoint(const char* host, long connectMs, long responseMs, int code) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        unsigned long requests = registry.count(host) ? registry[host].requests : 0;
+        registry[host] = { connectMs, responseMs, code, requests };
+    }
+
+    void removeEndpoint(const char* host) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.erase(host);
+    }
+
+    unsigned long getRequestCount(const char* host) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        return registry.count(host) ? registry[host].requests : 0;
+    }
+}
+
+bool HTTPClient::begin(const String& url) {
+    // "http://hôte[:port]/chemin" -> "hôte[:port]"
+    std::string s = url.c_str();
+    size_t start = s.find("://");
+    start = (start == std::string::npos) ? 0 : start + 3;
+    size_t slash = s.find('/', start);
+    host = s.substr(start, slash == std::string::npos ? std::string::npos : slash - start);
+    return true;
+}
+
+int HTTPClient::perform() {
+    Endpoint ep;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto it = registry.find(host);
+        if (it == registry.end()) {
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+        it->second.requests++;
+        ep = it->second;
+    }
+    
+    if (ep.connectMs < 0 || ep.connectMs > connectTimeoutMs) {
+        delay(connectTimeoutMs);
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    delay(ep.connectMs);
+    
+    if (ep.responseMs < 0 || ep.responseMs > (long)timeoutMs) {
+        delay(timeoutMs);
+        return HTTPC_ERROR_READ_TIMEOUT;
+    }
+    delay(ep.responseMs);
+    return ep.code;
+}
@@ -0,0 +1,192 @@
+#include "ESPAsyncWebServer.h"
+#include "ArduinoJson.h"
+#include "WiFi.h"
+
+#include <sys/stat.h>
+
+HostWiFi WiFi;
+fs::FS LittleFS;
+AsyncWebServer* AsyncWebServer::last = nullptr;
+
+namespace HostJson {
+    uint32_t internalOverflows = 0;
+}
+
+// --- LittleFS ---
+
+static std::string fsRoot = ".";
+
+namespace HostFS {
+    void setRoot(const char* dir) { fsRoot = dir; }
+}
+
+bool fs::FS::begin(bool) {
+    return true;
+}
+
+std::string fs::FS::hostPath(const char* path) const {
+    return fsRoot + path;
+}
+
+bool fs::FS::exists(const char* path) {
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+// --- Réponses ---
+
+const char* AsyncWebServerResponse::hostHeader(const char* name) const {
+    for (const auto& h : headers) {
+        if (strcmp(h.first.c_str(), name) == 0) return h.second.c_str();
+    }
+    return nullptr;
+}
+
+size_t AsyncResponseStream::printf(const char* fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n >= (int)sizeof(buf)) {
+        std::string big(n + 1, '\0');
+        va_start(args, fmt);
+        vsnprintf(&big[0], big.size(), fmt, args);
+        va_end(args);
+        content.append(big.c_str(), n);
+    } else if (n > 0) {
+        content.append(buf, n);
+    }
+    return n > 0 ? n : 0;
+}
+
+String AsyncCallbackResponse::hostBody() {
+    // Morceaux de la taille d'un segment TCP, comme _fillBuffer()
+    std::string body;
+    uint8_t chunk[1460];
+    while (body.size() < contentLength) {
+        size_t n = filler(chunk, std::min(sizeof(chunk), contentLength - body.size()), body.size());
+        if (n == 0) break;
+        body.append((const char*)chunk, n);
+    }
+    return String(body);
+}
+
+String AsyncFileResponse::hostBody() {
+    std::string body;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f) {
+        char chunk[1460];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+            body.append(chunk, n);
+        }
+        fclose(f);
+    }
+    return String(body);
+}
+
+// --- Requête ---
+
+AsyncWebServerRequest::AsyncWebServerRequest(WebRequestMethodComposite method, const char* url, IPAddress remote)
+    : httpMethod(method), tcpClient(remote), response(nullptr) {
+    const char* query = strchr(url, '?');
+    path = query ? String(std::string(url, query - url)) : String(url);
+    while (query && *query) {
+        const char* start = query + 1;
+        const char* end = strchr(start, '&');
+        std::string pair = end ? std::string(start, end - start) : std::string(start);
+        size_t eq = pair.find('=');
+        if (!pair.empty()) {
+            params.emplace_back(String(pair.substr(0, eq)),
+                                String(eq == std::string::npos ? std::string() : pair.substr(eq + 1)));
+        }
+        query = end;
+    }
+}
+
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+    delete response;
+}
+
+bool AsyncWebServerRequest::hasParam(const char* name) const {
+    return getParam(name) != nullptr;
+}
+
+const AsyncWebParameter* AsyncWebServerRequest::getParam(const char* name) const {
+    for (const auto& p : params) {
+        if (strcmp(p.getName().c_str(), name) == 0) return &p;
+    }
+    return nullptr;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const String& contentType,
+                                                             const String& content) {
+    return new AsyncBasicResponse(code, contentType, content);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(const String& contentType, size_t len,
+                                                             AwsResponseFiller callback) {
+    return new AsyncCallbackResponse(contentType, len, callback);
+}
+
+AsyncResponseStream* AsyncWebServerRequest::beginResponseStream(const String& contentType, size_t bufferSize) {
+    return new AsyncResponseStream(contentType, bufferSize);
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* resp) {
+    // Une seule réponse par requête : les suivantes sont ignorées
+    if (response) {
+        delete resp;
+        return;
+    }
+    response = resp;
+}
+
+void AsyncWebServerRequest::send(int code, const String& contentType, const String& content) {
+    send(beginResponse(code, contentType, content));
+}
+
+void AsyncWebServerRequest::send(FS& fs, const String& filePath, const String& contentType, bool) {
+    if (!fs.exists(filePath.c_str())) {
+        send(404);
+        return;
+    }
+    std::string hostPath = fs.hostPath(filePath.c_str());
+    struct stat st;
+    stat(hostPath.c_str(), &st);
+    send(new AsyncFileResponse(hostPath, contentType, (size_t)st.st_size));
+}
+
+void AsyncWebServerRequest::hostDisconnect() {
+    if (disconnectHandler) {
+        disconnectHandler();
+    }
+}
+
+// --- Serveur ---
+
+AsyncWebServer::AsyncWebServer(uint16_t) {
+    last = this;
+}
+
+void AsyncWebServer::on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest) {
+    routes.push_back({ String(uri), method, onRequest });
+}
+
+void AsyncWebServer::hostHandle(AsyncWebServerRequest* request) {
+    const std::string url = request->url().c_str();
+    for (const Route& route : routes) {
+        if (!(route.method & request->method())) continue;
+        const std::string uri = route.uri.c_str();
+        if (url == uri || (url.compare(0, uri.size() + 1, uri + "/") == 0)) {
+            route.handler(request);
+            return;
+        }
+    }
+    if (notFound) {
+        notFound(request);
+    } else {
+        request->send(404);
+    }
+}
@@ -0,0 +1,24 @@
+// Adresse IPv4 (WiFi.localIP(), AsyncClient::remoteIP())
+#ifndef HOST_IP_ADDRESS_H
+#define HOST_IP_ADDRESS_H
+
+#include "Arduino.h"
+
+class IPAddress {
+private:
+    uint32_t address;   // Octet de poids faible = premier octet, comme sur ESP32
+
+public:
+    IPAddress(uint32_t addr = 0) : address(addr) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : address(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+    operator uint32_t() const { return address; }
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", address & 0xFF, (address >> 8) & 0xFF,
+                 (address >> 16) & 0xFF, address >> 24);
+        return String(buf);
+    }
+};
+
+#endif
@@ -0,0 +1,24 @@
+// LittleFS hôte : les chemins sont résolus sous un dossier de l'hôte
+// (HostFS::setRoot), pour servir /trace.bin depuis ESP32APIServer
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include "Arduino.h"
+
+namespace fs {
+class FS {
+public:
+    bool begin(bool formatOnFail = false);
+    bool exists(const char* path);
+    // Chemin hôte correspondant, pour AsyncWebServerRequest::send(FS&, ...)
+    std::string hostPath(const char* path) const;
+};
+}
+using fs::FS;
+extern fs::FS LittleFS;
+
+namespace HostFS {
+    void setRoot(const char* dir);
+}
+
+#endif
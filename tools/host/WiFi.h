@@ -0,0 +1,25 @@
+// WiFi hôte : connecté immédiatement, IP fixe
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+#define WIFI_STA 1
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_CONNECTED = 3,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class HostWiFi {
+public:
+    void mode(int) {}
+    void begin(const char*, const char*) {}
+    wl_status_t status() { return WL_CONNECTED; }
+    IPAddress localIP() { return IPAddress(192, 168, 1, 50); }
+};
+extern HostWiFi WiFi;
+
+#endif
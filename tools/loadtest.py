@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+"""
+Générateur de charge HTTP pour l'API SmartGate.
+
+Rejoue un mélange configurable de requêtes (/api/status, /api/distance,
+POST /api/gate, /api/history, ...) soit à débit fixe (boucle ouverte), soit
+avec une concurrence fixe (boucle fermée), puis affiche débit, percentiles
+de latence, taux d'erreur et heap minimum observé (free_heap de /api/status).
+
+Cible : un vrai ESP32 uniquement. Sur l'hôte, la capacité des vrais handlers
+se mesure avec tools/api_capacity.cpp (clients virtuels, heap modélisé).
+
+Exemples:
+  python3 tools/loadtest.py --target 192.168.1.42 --concurrency 8 --duration 20
+  python3 tools/loadtest.py --target 192.168.1.42 --rate 5 --duration 60 \\
+      --mix status=60,distance=30,gate=5,root=5
+"""
+
+import argparse
+import http.client
+import json
+import random
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+MEMORY_WARNING_THRESHOLD = 50000  # include/ESP32Config.h
+
+# Nom dans --mix -> (méthode, chemin)
+ROUTES = {
+    "status": ("GET", "/api/status"),
+    "distance": ("GET", "/api/distance"),
+    "gate": ("POST", None),  # alterne open/close
+    "gate_get": ("GET", "/api/gate"),
+    "root": ("GET", "/"),
+    "esp32cam": ("GET", "/api/esp32cam"),
+    "capture": ("POST", "/api/capture"),
+    "history": ("GET", "/api/history?metric=distance&range=600000&points=100"),
+    "diagnostics": ("GET", "/api/diagnostics"),
+    "admission": ("GET", "/api/admission"),
+    "trace": ("GET", "/api/trace"),
+}
+
+
+def parse_mix(text):
+    mix = []
+    for item in text.split(","):
+        name, _, weight = item.partition("=")
+        name = name.strip()
+        if name not in ROUTES:
+            raise SystemExit(f"Unknown route in --mix: {name} (known: {', '.join(ROUTES)})")
+        mix.append((name, float(weight or 1)))
+    return mix
+
+
+def percentile(sorted_values, pct):
+    if not sorted_values:
+        return 0.0
+    index = min(len(sorted_values) - 1, int(round(pct / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+class Stats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.latencies = {}
+        self.errors = {}
+        self.shed = {}
+        self.codes = {}
+        self.min_free_heap = None
+
+    def record(self, route, latency, code, free_heap=None):
+        with self.lock:
+            self.latencies.setdefault(route, []).append(latency)
+            self.codes[code] = self.codes.get(code, 0) + 1
+            if code in (429, 503, 409):
+                # Rejet volontaire (contrôle d'admission, ronde de capture déjà en cours), compté à part
+                self.shed[route] = self.shed.get(route, 0) + 1
+            elif not isinstance(code, int) or code >= 400:
+                self.errors[route] = self.errors.get(route, 0) + 1
+            if free_heap is not None:
+                if self.min_free_heap is None or free_heap < self.min_free_heap:
+                    self.min_free_heap = free_heap
+
+
+class LoadGenerator:
+    def __init__(self, args):
+        host, _, port = args.target.partition(":")
+        self.host = host
+        self.port = int(port or 80)
+        self.timeout = args.timeout
+        self.mix = parse_mix(args.mix)
+        self.stats = Stats()
+        self.gate_toggle = False
+        self.gate_lock = threading.Lock()
+
+    def pick_route(self):
+        names = [name for name, _ in self.mix]
+        weights = [weight for _, weight in self.mix]
+        return random.choices(names, weights)[0]
+
+    def build_request(self, route):
+        method, path = ROUTES[route]
+        if route == "gate":
+            with self.gate_lock:
+                self.gate_toggle = not self.gate_toggle
+                action = "open" if self.gate_toggle else "close"
+            path = f"/api/gate?action={action}"
+        return method, path
+
+    def issue(self, route, scheduled_at=None):
+        method, path = self.build_request(route)
+        # En boucle ouverte la latence part de l'instant prévu (pas d'omission coordonnée)
+        start = scheduled_at if scheduled_at is not None else time.perf_counter()
+        free_heap = None
+        try:
+            conn = http.client.HTTPConnection(self.host, self.port, timeout=self.timeout)
+            conn.request(method, path, headers={"Connection": "close"})
+            resp = conn.getresponse()
+            body = resp.read()
+            code = resp.status
+            conn.close()
+            if route == "status" and code == 200:
+                free_heap = json.loads(body).get("free_heap")
+        except (OSError, http.client.HTTPException, ValueError) as exc:
+            code = type(exc).__name__
+        self.stats.record(route, time.perf_counter() - start, code, free_heap)
+
+    def run_closed_loop(self, concurrency, duration):
+        deadline = time.perf_counter() + duration
+
+        def worker():
+            while time.perf_counter() < deadline:
+                self.issue(self.pick_route())
+
+        threads = [threading.Thread(target=worker, daemon=True) for _ in range(concurrency)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+    def run_open_loop(self, rate, duration, max_workers):
+        interval = 1.0 / rate
+        start = time.perf_counter()
+        with ThreadPoolExecutor(max_workers=max_workers) as pool:
+            sent = 0
+            while True:
+                scheduled = start + sent * interval
+                if scheduled - start >= duration:
+                    break
+                now = time.perf_counter()
+                if scheduled > now:
+                    time.sleep(scheduled - now)
+                pool.submit(self.issue, self.pick_route(), scheduled)
+                sent += 1
+
+    def report(self, elapsed):
+        stats = self.stats
+        total = sum(len(v) for v in stats.latencies.values())
+        errors = sum(stats.errors.values())
+        shed = sum(stats.shed.values())
+        print(f"\n=== Load test: {self.host}:{self.port} ({elapsed:.1f} s) ===")
+        print(f"Requests: {total} | Throughput: {total / elapsed:.1f} req/s | "
+              f"Errors: {errors} ({100.0 * errors / max(total, 1):.1f}%) | "
+              f"Shed (429/503/409): {shed} ({100.0 * shed / max(total, 1):.1f}%)")
+        print(f"{'route':<10} {'count':>6} {'err':>5} {'shed':>5} {'p50 ms':>8} {'p90 ms':>8} "
+              f"{'p99 ms':>8} {'max ms':>8}")
+        for route, values in sorted(stats.latencies.items()):
+            values = sorted(values)
+            print(f"{route:<10} {len(values):>6} {stats.errors.get(route, 0):>5} "
+                  f"{stats.shed.get(route, 0):>5} "
+                  f"{percentile(values, 50) * 1000:>8.1f} {percentile(values, 90) * 1000:>8.1f} "
+                  f"{percentile(values, 99) * 1000:>8.1f} {values[-1] * 1000:>8.1f}")
+        print("Status codes: " + ", ".join(f"{k}={v}" for k, v in sorted(
+            stats.codes.items(), key=lambda kv: str(kv[0]))))
+
+        min_heap = stats.min_free_heap
+        if min_heap is not None:
+            flag = "⚠️  BELOW" if min_heap < MEMORY_WARNING_THRESHOLD else "OK, above"
+            print(f"Min free heap: {min_heap} bytes ({flag} MEMORY_WARNING_THRESHOLD={MEMORY_WARNING_THRESHOLD})")
+        else:
+            print("Min free heap: n/a (add 'status' to --mix to sample free_heap)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Test de charge de l'API SmartGate")
+    parser.add_argument("--target", required=True, help="IP[:port] de l'ESP32")
+    parser.add_argument("--mix", default="status=50,distance=30,gate=10,root=10",
+                        help="Poids par route: " + ",".join(ROUTES))
+    parser.add_argument("--duration", type=float, default=10.0, help="Durée (s)")
+    mode = parser.add_mutually_exclusive_group()
+    mode.add_argument("--rate", type=float, help="Boucle ouverte: requêtes par seconde")
+    mode.add_argument("--concurrency", type=int, default=4,
+                      help="Boucle fermée: nombre de clients simultanés")
+    parser.add_argument("--max-workers", type=int, default=64,
+                        help="Requêtes simultanées max en boucle ouverte")
+    parser.add_argument("--timeout", type=float, default=5.0, help="Timeout par requête (s)")
+    args = parser.parse_args()
+
+    generator = LoadGenerator(args)
+    start = time.perf_counter()
+    if args.rate:
+        print(f"🚀 Open loop: {args.rate} req/s for {args.duration} s")
+        generator.run_open_loop(args.rate, args.duration, args.max_workers)
+    else:
+        print(f"🚀 Closed loop: {args.concurrency} clients for {args.duration} s")
+        generator.run_closed_loop(args.concurrency, args.duration)
+    generator.report(time.perf_counter() - start)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""
+Mock de l'ESP32-CAM avec injection de fautes.
+
+Expose /capture (POST), /status (GET) et /stream (GET) comme la caméra
+réelle, avec latence, resets de connexion, erreurs 5xx et blocages
+injectables. Le mode peut être changé à chaud via /fault pour mesurer la
+latence de fast-fail et le temps de récupération du disjoncteur de
+ESP32CAMClient.
+
+Pointer le firmware dessus avec ESP32CAM_IP "<ip_du_pc>:8081".
+
+Usage:
+  python3 tools/mock_esp32cam.py --port 8081 --latency 0.2 --error-rate 0.1
+  curl "http://127.0.0.1:8081/fault?mode=down"    # toutes les requêtes échouent (reset)
+  curl "http://127.0.0.1:8081/fault?mode=hang"    # aucune réponse avant le timeout client
+  curl "http://127.0.0.1:8081/fault?mode=error"   # HTTP 503 systématique
+  curl "http://127.0.0.1:8081/fault?mode=up"      # retour à la normale
+"""
+
+import argparse
+import json
+import random
+import socket
+import struct
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+MODES = ("up", "down", "hang", "error")
+
+
+class FaultState:
+    """Mode courant et chronologie des pannes pour mesurer la récupération."""
+
+    def __init__(self, args):
+        self.lock = threading.Lock()
+        self.args = args
+        self.mode = "up"
+        self.recovered_at = None     # Instant du passage en "up"
+        self.waiting_first_ok = False
+        self.counters = {"ok": 0, "reset": 0, "error": 0, "hang": 0}
+
+    def set_mode(self, mode):
+        with self.lock:
+            previous = self.mode
+            self.mode = mode
+            if mode == "up" and previous != "up":
+                self.recovered_at = time.monotonic()
+                self.waiting_first_ok = True
+        print(f"🔧 Fault mode: {previous} -> {mode}")
+
+    def decide(self):
+        """Retourne l'issue de la prochaine requête : ok, reset, error ou hang."""
+        with self.lock:
+            mode = self.mode
+        if mode == "down":
+            return "reset"
+        if mode == "hang":
+            return "hang"
+        if mode == "error":
+            return "error"
+        roll = random.random()
+        if roll < self.args.reset_rate:
+            return "reset"
+        if roll < self.args.reset_rate + self.args.error_rate:
+            return "error"
+        return "ok"
+
+    def count(self, outcome):
+        with self.lock:
+            self.counters[outcome] += 1
+            if outcome == "ok" and self.waiting_first_ok:
+                self.waiting_first_ok = False
+                delay = time.monotonic() - self.recovered_at
+                print(f"✅ First successful request {delay * 1000:.0f} ms after recovery")
+
+    def snapshot(self):
+        with self.lock:
+            return {"mode": self.mode, **self.counters}
+
+
+class CamRequestHandler(BaseHTTPRequestHandler):
+    server_version = "ESP32CAMMock/1.0"
+
+    def log_message(self, fmt, *args):
+        if self.server.verbose:
+            super().log_message(fmt, *args)
+
+    def _send_json(self, code, payload):
+        body = json.dumps(payload).encode()
+        self.send_response(code)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def _reset_connection(self):
+        # SO_LINGER à 0 : fermeture par RST, comme une caméra qui redémarre
+        self.connection.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0))
+        self.connection.close()
+        self.close_connection = True
+
+    def _handle_camera(self, payload):
+        faults = self.server.faults
+        outcome = faults.decide()
+        faults.count(outcome)
+
+        if outcome == "reset":
+            self._reset_connection()
+            return
+        if outcome == "hang":
+            time.sleep(self.server.hang_seconds)
+            self._reset_connection()
+            return
+
+        args = self.server.args
+        time.sleep(max(0.0, args.latency + random.uniform(-args.jitter, args.jitter)))
+        if outcome == "error":
+            self._send_json(503, {"error": "injected fault"})
+        else:
+            self._send_json(200, payload)
+
+    def do_GET(self):
+        url = urlparse(self.path)
+        if url.path == "/fault":
+            mode = parse_qs(url.query).get("mode", [""])[0]
+            if mode not in MODES:
+                self._send_json(400, {"error": f"mode must be one of {', '.join(MODES)}"})
+                return
+            self.server.faults.set_mode(mode)
+            self._send_json(200, self.server.faults.snapshot())
+        elif url.path == "/faults":
+            self._send_json(200, self.server.faults.snapshot())
+        elif url.path == "/status":
+            self._handle_camera({"status": "ok", "camera": "mock", "uptime": int(time.monotonic())})
+        elif url.path == "/stream":
+            self._handle_camera({"status": "ok", "stream": "not available in mock"})
+        else:
+            self._send_json(404, {"error": "not found"})
+
+    def do_POST(self):
+        length = int(self.headers.get("Content-Length", 0) or 0)
+        if length:
+            self.rfile.read(length)
+        if urlparse(self.path).path == "/capture":
+            self._handle_camera({"status": "success", "message": "Photo captured"})
+        else:
+            self._send_json(404, {"error": "not found"})
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Mock ESP32-CAM avec injection de fautes")
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8081)
+    parser.add_argument("--latency", type=float, default=0.1, help="Latence de base (s)")
+    parser.add_argument("--jitter", type=float, default=0.02, help="Gigue +/- (s)")
+    parser.add_argument("--error-rate", type=float, default=0.0, help="Probabilité de 503")
+    parser.add_argument("--reset-rate", type=float, default=0.0, help="Probabilité de reset TCP")
+    parser.add_argument("--hang", type=float, default=10.0,
+                        help="Durée d'un blocage en mode hang (s)")
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer((args.host, args.port), CamRequestHandler)
+    server.daemon_threads = True
+    server.args = args
+    server.faults = FaultState(args)
+    server.hang_seconds = args.hang
+    server.verbose = args.verbose
+    print(f"📷 Mock ESP32-CAM on http://{args.host}:{args.port}")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print(f"📊 {server.faults.snapshot()}")
+        server.server_close()
+
+
+if __name__ == "__main__":
+    main()
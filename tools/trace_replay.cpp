@@ -0,0 +1,377 @@
+// Rejeu hôte des traces SmartGate (GET /api/trace ou /trace.bin en flash).
+//
+// Les durées d'écho brutes enregistrées sont réinjectées dans le vrai
+// DistanceSensor (src/DistanceSensor.cpp compilé avec tools/host/Arduino.h)
+// sur une horloge virtuelle : le rejeu est déterministe et aussi rapide que
+// le CPU le permet. La décision d'ouverture anticipée et de refermeture est
+// celle du firmware (ApproachEstimator -> GateAutomation -> ServoController) ;
+// les mouvements API enregistrés sont rejoués, ceux de l'automatisme
+// enregistré sont ignorés et redécidés avec les paramètres du rejeu.
+//
+// Compilation :
+//   g++ -O2 -std=c++17 -pthread -Itools/host -Iinclude tools/host/HostArduino.cpp
+//       tools/host/HostFreeRTOS.cpp src/DistanceSensor.cpp src/ApproachEstimator.cpp
+//       src/TraceRecorder.cpp src/DeadlineMonitor.cpp src/ServoController.cpp
+//       src/GateAutomation.cpp tools/trace_replay.cpp -o trace_replay
+//
+// Usage :
+//   ./trace_replay trace.bin [--threshold 20] [--min-presence-ms 1000]
+//                  [--early-open] [--lead-ms 1500] [--close-after-ms 3000]
+//   ./trace_replay --synth synth.bin --hours 8 [--seed 1]   # génère une trace synthétique
+
+#include "Arduino.h"
+#include "ESP32Config.h"
+#include "DeadlineMonitor.h"
+#include "DistanceSensor.h"
+#include "ServoController.h"
+#include "GateAutomation.h"
+#include "TraceRecorder.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#define LOOP_MS 200             // Cadence de loop() entre deux échos enregistrés
+#define PRESENCE_HOLD_MS 1000   // Écho manqué toléré avant de considérer le véhicule parti
+
+struct ReplayOptions {
+    float thresholdCm = DETECTION_DISTANCE_CM;
+    unsigned long minPresenceMs = 1000;     // Présence plus courte = faux déclenchement
+    unsigned long gateWindowMs = 30000;     // Fenêtre arrivée -> ouverture barrière
+    bool earlyOpen = APPROACH_EARLY_OPEN;
+    unsigned long leadMs = APPROACH_LEAD_MS;
+    unsigned long closeAfterMs = APPROACH_CLOSE_AFTER_CLEAR_MS;
+};
+
+struct ReplayReport {
+    uint64_t echoSamples = 0;
+    uint64_t echoTimeouts = 0;
+    uint64_t detections = 0;
+    uint64_t falseTriggers = 0;
+    uint64_t operatorMoves = 0;
+    uint64_t recordedAutoMoves = 0;
+    uint64_t arrivalsWithoutOpen = 0;
+    uint64_t apiCalls[16] = {};
+    GateAutomation::Stats automation = {};
+    bool automationActiveAtEnd = false;
+    std::vector<long> arrivalToOpenMs;          // Arrivée au seuil -> barrière ouverte (< 0 = ouverte avant)
+    std::vector<long> lastEchoToCloseMs;        // Dernier écho sous le seuil -> refermeture automatique
+    uint32_t digest = 2166136261u;              // FNV-1a des instants de détection et de mouvement
+    unsigned long spanMs = 0;
+};
+
+static GateAutomation* automation = nullptr;
+
+static void onApproach(float, float, float) {
+    automation->requestOpen();
+}
+
+static bool loadTrace(const char* path, std::vector<TraceRecord>& records, TraceHeader& header) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+    if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != TRACE_MAGIC ||
+        header.recordSize != sizeof(TraceRecord)) {
+        fprintf(stderr, "%s: not a SmartGate trace (version %u)\n", path, TRACE_VERSION);
+        fclose(f);
+        return false;
+    }
+    // recordCount = 0 pour les traces flash : lire jusqu'à la fin du fichier
+    TraceRecord r;
+    while (fread(&r, sizeof(r), 1, f) == 1) {
+        records.push_back(r);
+        if (header.recordCount && records.size() == header.recordCount) break;
+    }
+    fclose(f);
+    return true;
+}
+
+static void percentiles(const char* label, std::vector<long> values) {
+    if (values.empty()) {
+        printf("%-34s n/a\n", label);
+        return;
+    }
+    std::sort(values.begin(), values.end());
+    auto at = [&](double p) { return values[(size_t)(p * (values.size() - 1))]; };
+    printf("%-34s p10=%ld ms p50=%ld ms p90=%ld ms max=%ld ms (n=%zu)\n",
+           label, at(0.1), at(0.5), at(0.9), values.back(), values.size());
+}
+
+static void mix(ReplayReport& report, uint32_t value) {
+    report.digest = (report.digest ^ value) * 16777619u;
+}
+
+static ReplayReport replay(const std::vector<TraceRecord>& records, const ReplayOptions& opt) {
+    ReplayReport report;
+    if (records.empty()) {
+        return report;
+    }
+    HostArduino::setMillis(records.front().timestampMs);
+    DeadlineMonitor::init();
+    DistanceSensor sensor(TRIG_PIN, ECHO_PIN);
+    ServoController servo(SERVO_PIN);
+    GateAutomation gate(sensor, servo, opt.earlyOpen, opt.thresholdCm, opt.closeAfterMs);
+    automation = &gate;
+    sensor.init();
+    servo.init();
+    sensor.getEstimator().setApproachCallback(onApproach, opt.thresholdCm, opt.leadMs);
+
+    bool detected = false;
+    bool gateOpen = false;
+    bool awaitingOpen = false;
+    unsigned long detectStart = 0;
+    unsigned long openedAt = 0;
+    unsigned long lastNearEcho = 0;
+    uint32_t closedPassed = 0;
+
+    // Après chaque mouvement possible : instants d'ouverture, arrivées en attente
+    auto observeGate = [&]() {
+        bool open = servo.isGateOpen();
+        if (open == gateOpen) return;
+        gateOpen = open;
+        mix(report, millis() ^ (open ? 0x80000000u : 0));
+        if (open) {
+            openedAt = millis();
+            if (awaitingOpen) {
+                report.arrivalToOpenMs.push_back((long)(openedAt - detectStart));
+                awaitingOpen = false;
+            }
+        }
+    };
+    // Itération de loop() sans écho : seul l'automatisme tourne
+    auto runAutomation = [&]() {
+        gate.update(millis());
+        if (gate.getStats().closedPassed != closedPassed) {
+            closedPassed = gate.getStats().closedPassed;
+            report.lastEchoToCloseMs.push_back((long)(millis() - lastNearEcho));
+        }
+        observeGate();
+    };
+
+    for (const TraceRecord& r : records) {
+        // Les mouvements servo de l'automatisme bloquent loop() (delay) : l'horloge
+        // virtuelle ne recule jamais, les échos suivants sont simplement décalés
+        while (millis() + LOOP_MS < r.timestampMs) {
+            delay(LOOP_MS);
+            runAutomation();
+        }
+        if (millis() < r.timestampMs) {
+            HostArduino::setMillis(r.timestampMs);
+        }
+
+        if (r.type == TRACE_ECHO) {
+            report.echoSamples++;
+            long duration = (r.value == 0xFFFF) ? 0 : r.value;
+            if (duration == 0) report.echoTimeouts++;
+
+            HostArduino::setNextPulse(duration);
+            sensor.readDistance();
+            // Présence : écho valide sous le seuil, un écho manqué toléré (la
+            // dernière distance n'est pas effacée quand le véhicule sort du champ)
+            if (sensor.getLastValidReadTime() == millis() && sensor.isObjectDetected(opt.thresholdCm)) {
+                lastNearEcho = millis();
+            }
+            bool now = lastNearEcho != 0 && millis() - lastNearEcho <= PRESENCE_HOLD_MS;
+
+            if (now && !detected) {
+                report.detections++;
+                detectStart = millis();
+                mix(report, detectStart);
+                if (gateOpen) {
+                    report.arrivalToOpenMs.push_back(-(long)(detectStart - openedAt));
+                } else {
+                    if (awaitingOpen) report.arrivalsWithoutOpen++;
+                    awaitingOpen = true;
+                }
+            } else if (!now && detected) {
+                if (lastNearEcho - detectStart < opt.minPresenceMs) {
+                    report.falseTriggers++;
+                    awaitingOpen = false;
+                }
+            }
+            detected = now;
+            runAutomation();
+        } else if (r.type == TRACE_API_CALL) {
+            report.apiCalls[r.value & 15]++;
+        } else if (r.type == TRACE_GATE) {
+            if (r.flags & TRACE_GATE_AUTO) {
+                report.recordedAutoMoves++;
+                continue;
+            }
+            // Commande API : exécutée dans la tâche AsyncTCP sur la carte, elle ne
+            // retarde pas loop() ; l'horloge est remise à l'instant de la commande
+            report.operatorMoves++;
+            unsigned long at = millis();
+            if (r.flags & TRACE_GATE_OPEN) {
+                servo.openGate();
+            } else {
+                servo.closeGate();
+            }
+            HostArduino::setMillis(at);
+            observeGate();
+        }
+        if (awaitingOpen && millis() - detectStart > opt.gateWindowMs) {
+            report.arrivalsWithoutOpen++;
+            awaitingOpen = false;
+        }
+    }
+
+    report.automation = gate.getStats();
+    report.automationActiveAtEnd = gate.isActive();
+    report.spanMs = records.back().timestampMs - records.front().timestampMs;
+    automation = nullptr;
+    return report;
+}
+
+// Trace synthétique : champ libre (pas d'écho), véhicules qui entrent dans la
+// portée du capteur à vitesse variable, s'arrêtent devant la barrière puis
+// passent dessous, fausses détections brèves, ouvertures/fermetures par
+// l'opérateur et polling du dashboard.
+static bool writeSynthetic(const char* path, double hours, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> noise(-1.5f, 1.5f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<TraceRecord> records;
+
+    auto push = [&](uint32_t t, uint8_t type, uint8_t flags, uint16_t value) {
+        records.push_back({ t, type, flags, value });
+    };
+    auto echoFor = [](float cm) { return (uint16_t)(cm * 2 / 0.034f); };
+
+    const float entryCm = 350.0f;       // Entrée dans la portée du capteur
+    const float stopCm = 10.0f;
+    const uint32_t endMs = (uint32_t)(hours * 3600000.0);
+    uint32_t nextVehicle = 20000;
+    uint32_t nextGlitch = 45000;
+    uint32_t vehicleStart = 0;
+    uint32_t arrival = 0;               // Fin de l'approche
+    float speed = 0;                    // cm/s
+    bool inVehicle = false;
+    bool gateOpened = false;
+
+    for (uint32_t t = 0; t < endMs; t += 500) {
+        float cm = -1.0f;               // Champ libre : timeout
+
+        if (!inVehicle && t >= nextVehicle) {
+            inVehicle = true;
+            gateOpened = false;
+            vehicleStart = t;
+            speed = 40.0f + unit(rng) * 110.0f;
+            arrival = t + (uint32_t)((entryCm - stopCm) / speed * 1000.0f);
+        }
+        if (inVehicle) {
+            if (t < arrival) {
+                cm = entryCm - (t - vehicleStart) * speed / 1000.0f + noise(rng);   // Approche
+            } else if (t < arrival + 8000) {
+                cm = stopCm + noise(rng);                                           // Arrêt devant la barrière
+                if (!gateOpened && t >= arrival + 2000) {
+                    push(t, TRACE_API_CALL, 0, TRACE_ROUTE_GATE_POST);
+                    push(t, TRACE_GATE, TRACE_GATE_OPEN, 0);
+                    gateOpened = true;
+                }
+            } else if (t >= arrival + 14000) {
+                // Passé sous la barrière, l'opérateur referme en retard
+                push(t, TRACE_API_CALL, 0, TRACE_ROUTE_GATE_POST);
+                push(t, TRACE_GATE, 0, 95);
+                inVehicle = false;
+                nextVehicle = t + 60000 + (uint32_t)(unit(rng) * 120000);
+            }
+        } else if (t >= nextGlitch) {
+            cm = 8.0f + noise(rng);                                                 // Passant / reflet
+            nextGlitch = t + 120000 + (uint32_t)(unit(rng) * 300000);
+        }
+
+        push(t, TRACE_ECHO, 0, (cm < 0 || unit(rng) < 0.01f) ? 0 : echoFor(cm));
+        if (t % 2000 == 0) {
+            push(t, TRACE_API_CALL, 0, TRACE_ROUTE_STATUS);
+        }
+    }
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    TraceHeader header = { TRACE_MAGIC, TRACE_VERSION, sizeof(TraceRecord),
+                           (uint32_t)records.size(), 0 };
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(records.data(), sizeof(TraceRecord), records.size(), f);
+    fclose(f);
+    printf("Wrote %zu records (%.1f h, %zu KB) to %s\n", records.size(), hours,
+           records.size() * sizeof(TraceRecord) / 1024, path);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    ReplayOptions opt;
+    const char* input = nullptr;
+    const char* synthPath = nullptr;
+    double hours = 1.0;
+    unsigned seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threshold" && i + 1 < argc) opt.thresholdCm = atof(argv[++i]);
+        else if (arg == "--min-presence-ms" && i + 1 < argc) opt.minPresenceMs = atol(argv[++i]);
+        else if (arg == "--gate-window-ms" && i + 1 < argc) opt.gateWindowMs = atol(argv[++i]);
+        else if (arg == "--early-open") opt.earlyOpen = true;
+        else if (arg == "--lead-ms" && i + 1 < argc) opt.leadMs = atol(argv[++i]);
+        else if (arg == "--close-after-ms" && i + 1 < argc) opt.closeAfterMs = atol(argv[++i]);
+        else if (arg == "--synth" && i + 1 < argc) synthPath = argv[++i];
+        else if (arg == "--hours" && i + 1 < argc) hours = atof(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = (unsigned)atoi(argv[++i]);
+        else if (arg == "--verbose") Serial.quiet = false;
+        else input = argv[i];
+    }
+
+    if (synthPath) {
+        return writeSynthetic(synthPath, hours, seed) ? 0 : 1;
+    }
+    if (!input) {
+        fprintf(stderr, "Usage: %s trace.bin [--threshold cm] [--min-presence-ms ms]\n"
+                        "                    [--early-open] [--lead-ms ms] [--close-after-ms ms]\n"
+                        "       %s --synth out.bin --hours H [--seed N]\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    std::vector<TraceRecord> records;
+    TraceHeader header;
+    if (!loadTrace(input, records, header)) return 1;
+
+    auto start = std::chrono::steady_clock::now();
+    ReplayReport report = replay(records, opt);
+    double wallMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    static const char* routes[] = { "other", "/", "/api/status", "/api/distance", "GET /api/gate",
+                                    "POST /api/gate", "/api/photo", "/api/auto", "/api/esp32cam",
+                                    "/api/capture", "/api/history", "/api/diagnostics" };
+
+    printf("=== Trace replay: %s ===\n", input);
+    printf("Records: %zu | Span: %.1f min | Replay: %.1f ms (x%.0f real time)\n",
+           records.size(), report.spanMs / 60000.0, wallMs,
+           wallMs > 0 ? report.spanMs / wallMs : 0.0);
+    printf("Threshold: %.1f cm | Min presence: %lu ms | Early open: %s (lead %lu ms, close after %lu ms)\n",
+           opt.thresholdCm, opt.minPresenceMs, opt.earlyOpen ? "on" : "off", opt.leadMs, opt.closeAfterMs);
+    printf("Echo samples: %llu (timeouts: %llu)\n",
+           (unsigned long long)report.echoSamples, (unsigned long long)report.echoTimeouts);
+    printf("Detections: %llu | False triggers: %llu | Arrivals without gate open: %llu\n",
+           (unsigned long long)report.detections, (unsigned long long)report.falseTriggers,
+           (unsigned long long)report.arrivalsWithoutOpen);
+    printf("Gate moves: %llu by API (replayed), %llu automatic in the trace (ignored, re-decided)\n",
+           (unsigned long long)report.operatorMoves, (unsigned long long)report.recordedAutoMoves);
+    const GateAutomation::Stats& a = report.automation;
+    printf("Automation: %u announcements, %u early opens, %u closed after passage, %u no-show%s\n",
+           a.requests, a.opens, a.closedPassed, a.closedNoShow,
+           report.automationActiveAtEnd ? " (still open at end of trace)" : "");
+    percentiles("Arrival -> gate open (<0 = before):", report.arrivalToOpenMs);
+    percentiles("Last echo -> automatic close:", report.lastEchoToCloseMs);
+    for (size_t i = 0; i < sizeof(routes) / sizeof(routes[0]); i++) {
+        if (report.apiCalls[i]) {
+            printf("API %-16s %llu\n", routes[i], (unsigned long long)report.apiCalls[i]);
+        }
+    }
+    printf("Replay digest: %08x\n", report.digest);
+    return 0;
+}